@@ -1,42 +1,68 @@
 // Contact.cpp
 #include "Contact.hpp"
 #include <iostream>
+#include <utility>
 
 namespace contact_management { // Everything in a self-made namespace
 
 // Contact class implementation
 
-Contact::Contact() : m_name(""), m_phone(""), m_email("") {} // Default constructor with member initialization
+Contact::Contact() : m_name(""), m_phone(""), m_email(""), m_kind(ContactKind::Personal) {} // Default constructor with member initialization
 
-Contact::Contact(const std::string& name, const std::string& phone, const std::string& email)
-    : m_name(name), m_phone(phone), m_email(email) {} // Parameterized constructor with member initialization
+Contact::Contact(std::string name, std::string phone, std::string email)
+    : Contact(std::move(name), std::move(phone), std::move(email), ContactKind::Personal) {} // Parameterized constructor, strings moved in
 
-Contact::Contact(const Contact& other)
-    : m_name(other.m_name), m_phone(other.m_phone), m_email(other.m_email) {} // Copy constructor with member initialization
+Contact::Contact(std::string name, std::string phone, std::string email, ContactKind kind)
+    : m_name(std::move(name)), m_phone(std::move(phone)), m_email(std::move(email)), m_kind(kind) {}
+
+// Copying a business contact into a plain Contact slices it, so the copy is personal
+Contact::Contact(const Contact& other) : Contact(other, ContactKind::Personal) {} // Copy constructor
+
+Contact::Contact(const Contact& other, ContactKind kind)
+    : m_name(other.m_name), m_phone(other.m_phone), m_email(other.m_email), m_kind(kind) {}
+
+Contact::Contact(Contact&& other) noexcept : Contact(std::move(other), ContactKind::Personal) {} // Move constructor
+
+Contact::Contact(Contact&& other, ContactKind kind) noexcept
+    : m_name(std::move(other.m_name)), m_phone(std::move(other.m_phone)), m_email(std::move(other.m_email)), m_kind(kind) {}
+
+Contact& Contact::operator=(const Contact& other) {
+    m_name = other.m_name;
+    m_phone = other.m_phone;
+    m_email = other.m_email;
+    return *this;
+}
+
+Contact& Contact::operator=(Contact&& other) noexcept {
+    m_name = std::move(other.m_name);
+    m_phone = std::move(other.m_phone);
+    m_email = std::move(other.m_email);
+    return *this;
+}
 
 Contact::~Contact() {} // Destructor
 
-void Contact::setName(const std::string& name) {
-    this->m_name = name;
+void Contact::setName(std::string name) {
+    this->m_name = std::move(name);
 }
 
-std::string Contact::getName() const {
+const std::string& Contact::getName() const {
     return m_name;
 }
 
-void Contact::setPhone(const std::string& phone) {
-    this->m_phone = phone;
+void Contact::setPhone(std::string phone) {
+    this->m_phone = std::move(phone);
 }
 
-std::string Contact::getPhone() const {
+const std::string& Contact::getPhone() const {
     return m_phone;
 }
 
-void Contact::setEmail(const std::string& email) {
-    this->m_email = email;
+void Contact::setEmail(std::string email) {
+    this->m_email = std::move(email);
 }
 
-std::string Contact::getEmail() const {
+const std::string& Contact::getEmail() const {
     return m_email;
 }
 
@@ -48,21 +74,37 @@ void Contact::displayDetails() const {
 
 // BusinessContact class implementation
 
-BusinessContact::BusinessContact() : Contact(), m_company("") {} // Default constructor with member initialization and constructor forwarding
+BusinessContact::BusinessContact()
+    : Contact("", "", "", ContactKind::Business), m_company("") {} // Default constructor with member initialization and constructor forwarding
 
-BusinessContact::BusinessContact(const std::string& name, const std::string& phone, const std::string& email, const std::string& company)
-    : Contact(name, phone, email), m_company(company) {} // Parameterized constructor with member initialization and constructor forwarding
+BusinessContact::BusinessContact(std::string name, std::string phone, std::string email, std::string company)
+    : Contact(std::move(name), std::move(phone), std::move(email), ContactKind::Business), m_company(std::move(company)) {} // Parameterized constructor, strings moved in
 
 BusinessContact::BusinessContact(const BusinessContact& other)
-    : Contact(other), m_company(other.m_company) {} // Copy constructor with member initialization and constructor forwarding
+    : Contact(other, ContactKind::Business), m_company(other.m_company) {} // Copy constructor with member initialization and constructor forwarding
+
+BusinessContact::BusinessContact(BusinessContact&& other) noexcept
+    : Contact(std::move(other), ContactKind::Business), m_company(std::move(other.m_company)) {} // Move constructor, the base only takes its own members
+
+BusinessContact& BusinessContact::operator=(const BusinessContact& other) {
+    Contact::operator=(other);
+    m_company = other.m_company;
+    return *this;
+}
+
+BusinessContact& BusinessContact::operator=(BusinessContact&& other) noexcept {
+    Contact::operator=(std::move(other));
+    m_company = std::move(other.m_company);
+    return *this;
+}
 
 BusinessContact::~BusinessContact() {} // Destructor
 
-void BusinessContact::setCompany(const std::string& company) {
-    m_company = company;
+void BusinessContact::setCompany(std::string company) {
+    m_company = std::move(company);
 }
 
-std::string BusinessContact::getCompany() const {
+const std::string& BusinessContact::getCompany() const {
     return m_company;
 }
 
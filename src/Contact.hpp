@@ -3,39 +3,75 @@
 #define CONTACT_H
 
 #include <string>
+#include <string_view>
 #include <memory>
 
 namespace contact_management { // Everything in a self-made namespace
 
+// Type tag for contacts, used instead of dynamic_cast in bulk code paths
+enum class ContactKind : unsigned char {
+    Personal,
+    Business
+};
+
+// Selects a contact field for sorting and searching
+enum class ContactField : unsigned char {
+    Name,
+    Phone,
+    Email,
+    Company // Empty for personal contacts
+};
+
 class Contact {
 public:
     // Default constructor
     Contact();
     
-    // Parameterized constructor
-    Contact(const std::string& name, const std::string& phone, const std::string& email);
+    // Parameterized constructor, taken by value so callers can move their strings in
+    Contact(std::string name, std::string phone, std::string email);
     
     // Copy constructor
     Contact(const Contact& other);
+
+    // Move constructor and assignment (not implicit because of the user-declared copy constructor)
+    Contact(Contact&& other) noexcept;
+    Contact& operator=(const Contact& other);
+    Contact& operator=(Contact&& other) noexcept;
     
     // Destructor
     virtual ~Contact();
 
     // Getter and setter for name
-    void setName(const std::string& name); // Const reference for function parameter
-    std::string getName() const; // Const member function
+    void setName(std::string name); // By value, moved into place
+    const std::string& getName() const; // Const member function, no copy
 
     // Getter and setter for phone
-    void setPhone(const std::string& phone); // Const reference for function parameter
-    std::string getPhone() const; // Const member function
+    void setPhone(std::string phone);
+    const std::string& getPhone() const;
 
     // Getter and setter for email
-    void setEmail(const std::string& email); // Const reference for function parameter
-    std::string getEmail() const; // Const member function
+    void setEmail(std::string email);
+    const std::string& getEmail() const;
+
+    // Non-copying accessors, valid until the contact is modified or destroyed
+    std::string_view getNameView() const { return m_name; }
+    std::string_view getPhoneView() const { return m_phone; }
+    std::string_view getEmailView() const { return m_email; }
+
+    // Kind tag, set by the constructor: lets bulk code branch on a byte instead of using dynamic_cast
+    ContactKind getKind() const { return m_kind; }
+    bool isBusiness() const { return m_kind == ContactKind::Business; }
+    std::string_view getCompanyView() const; // Empty for personal contacts
 
     // Virtual function for displaying contact details (dynamic polymorphism)
     virtual void displayDetails() const;
 
+protected:
+    // For derived classes, which pass their own kind
+    Contact(std::string name, std::string phone, std::string email, ContactKind kind);
+    Contact(const Contact& other, ContactKind kind);
+    Contact(Contact&& other, ContactKind kind) noexcept;
+
 /*
     // New function to create a shared_ptr of Contact
     static std::shared_ptr<Contact> create(const std::string& name, const std::string& phone, const std::string& email) {
@@ -43,29 +79,39 @@ public:
     }
 */
 private:
+    // Owned strings, not views into a loader's StringPool: the getters return const std::string&, and an
+    // arena would only cut the heap blocks of the fields, about a sixth of the peak memory of a load
     std::string m_name; // Member variable
     std::string m_phone; // Member variable
     std::string m_email; // Member variable
+    ContactKind m_kind;  // Not assigned by operator=, it describes the object's own class
 };
 
-// BusinessContact class derived from Contact (dynamic polymorphism)
-class BusinessContact : public Contact {
+// BusinessContact class derived from Contact (dynamic polymorphism).
+// Final: the kind tag only tells these two classes apart.
+class BusinessContact final : public Contact {
 public:
     // Default constructor
     BusinessContact();
     
     // Parameterized constructor
-    BusinessContact(const std::string& name, const std::string& phone, const std::string& email, const std::string& company);
+    BusinessContact(std::string name, std::string phone, std::string email, std::string company);
     
     // Copy constructor
     BusinessContact(const BusinessContact& other);
+
+    // Move constructor and assignment
+    BusinessContact(BusinessContact&& other) noexcept;
+    BusinessContact& operator=(const BusinessContact& other);
+    BusinessContact& operator=(BusinessContact&& other) noexcept;
     
     // Destructor
     ~BusinessContact() override;
 
     // Getter and setter for company
-    void setCompany(const std::string& company); // Const reference for function parameter
-    std::string getCompany() const; // Const member function
+    void setCompany(std::string company); // By value, moved into place
+    const std::string& getCompany() const; // Const member function, no copy
+    std::string_view getCompanyView() const { return m_company; } // Non-copying accessor
 
     // Override displayDetails function (dynamic polymorphism)
     void displayDetails() const override;
@@ -82,6 +128,10 @@ private:
     std::string m_company; // Member variable
 };
 
+inline std::string_view Contact::getCompanyView() const {
+    return isBusiness() ? static_cast<const BusinessContact*>(this)->getCompanyView() : std::string_view();
+}
+
 } // namespace contact_management
 
 #endif // CONTACT_H
\ No newline at end of file
@@ -0,0 +1,324 @@
+// ContactColumns.cpp
+#include "ContactColumns.hpp"
+#include <ostream>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace contact_management { // Everything in a self-made namespace
+
+// StringColumn implementation
+
+StringColumn::StringColumn() : m_offsets(1, 0) {} // Offsets always hold one more entry than rows
+
+void StringColumn::clear() {
+    m_data.clear();
+    m_offsets.assign(1, 0);
+}
+
+void StringColumn::reserve(std::size_t rows, std::size_t bytes) {
+    m_offsets.reserve(rows + 1);
+    m_data.reserve(bytes);
+}
+
+void StringColumn::append(std::string_view value) {
+    m_data.append(value.data(), value.size());
+    m_offsets.push_back(m_data.size());
+}
+
+void StringColumn::assign(std::string_view bytes, std::vector<std::size_t> offsets) {
+    if (offsets.empty() || offsets.front() != 0 || offsets.back() != bytes.size()) {
+        throw std::runtime_error("Invalid string column");
+    }
+    for (std::size_t i = 1; i < offsets.size(); ++i) {
+        if (offsets[i] < offsets[i - 1]) {
+            throw std::runtime_error("Invalid string column");
+        }
+    }
+    m_data.assign(bytes.data(), bytes.size());
+    m_offsets = std::move(offsets);
+}
+
+// ContactColumns implementation
+
+void ContactColumns::clear() {
+    m_names.clear();
+    m_phones.clear();
+    m_emails.clear();
+    m_companies.clear();
+    m_companyPool.clear();
+    m_kinds.clear();
+}
+
+void ContactColumns::reserve(std::size_t rows) {
+    // Rough per-field byte estimates, the buffers still grow if needed
+    m_names.reserve(rows, rows * 16);
+    m_phones.reserve(rows, rows * 12);
+    m_emails.reserve(rows, rows * 24);
+    m_companies.reserve(rows);
+    m_kinds.reserve(rows);
+}
+
+ContactColumns::RowId ContactColumns::append(const Contact& contact) {
+    return append(contact.getNameView(), contact.getPhoneView(), contact.getEmailView(), contact.getCompanyView(), contact.getKind());
+}
+
+ContactColumns::RowId ContactColumns::append(std::string_view name, std::string_view phone, std::string_view email,
+                                             std::string_view company, ContactKind kind) {
+    m_names.append(name);
+    m_phones.append(phone);
+    m_emails.append(email);
+    m_companies.push_back(m_companyPool.intern(company));
+    m_kinds.push_back(kind);
+    return m_kinds.size() - 1;
+}
+
+// Binary snapshot format
+//
+// All integers are in host byte order; the byte order mark rejects snapshots written on a
+// machine with a different one. Every section is padded to 8 bytes so the checksum can run
+// over 64-bit words and the u64 arrays stay aligned inside a mapping.
+//
+//   header   SnapshotHeader (below)
+//   kinds    rowCount x u8 (ContactKind)
+//   name     (rowCount + 1) x u64 offsets, then the concatenated bytes
+//   phone    same layout
+//   email    same layout
+//   company  dictionary: (companyCount + 1) x u64 offsets, then bytes; then rowCount x u32 dictionary indexes
+
+namespace {
+
+const char snapshotMagic[8] = {'C', 'M', 'S', 'N', 'A', 'P', '\0', '\0'};
+const std::uint32_t snapshotVersion = 1;
+const std::uint32_t snapshotByteOrderMark = 0x01020304;
+
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrderMark;
+    std::uint64_t rowCount;
+    std::uint64_t companyCount;
+    std::uint64_t payloadSize; // Bytes after the header
+    std::uint64_t checksum;    // snapshotChecksum over the payload
+    std::uint64_t reserved[2];
+};
+static_assert(sizeof(SnapshotHeader) == 64, "Snapshot header layout must not change");
+
+std::size_t paddedSize(std::size_t size) {
+    return (size + 7) & ~static_cast<std::size_t>(7);
+}
+
+// FNV-1a style hash over 64-bit words (one multiply per 8 bytes); size must be a multiple of 8
+std::uint64_t snapshotChecksum(std::uint64_t hash, const char* data, std::size_t size) {
+    for (std::size_t i = 0; i < size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+const std::uint64_t snapshotChecksumSeed = 0xcbf29ce484222325ULL;
+
+std::vector<std::uint64_t> toU64(const std::vector<std::size_t>& values) {
+    return std::vector<std::uint64_t>(values.begin(), values.end());
+}
+
+// Collects payload sections, checksums them and writes them with padding
+class SnapshotWriter {
+public:
+    void add(const void* data, std::size_t size) {
+        m_sections.push_back({static_cast<const char*>(data), size});
+    }
+
+    std::uint64_t payloadSize() const {
+        std::uint64_t total = 0;
+        for (const auto& section : m_sections) {
+            total += paddedSize(section.size);
+        }
+        return total;
+    }
+
+    std::uint64_t checksum() const {
+        std::uint64_t hash = snapshotChecksumSeed;
+        for (const auto& section : m_sections) {
+            std::size_t whole = section.size & ~static_cast<std::size_t>(7);
+            hash = snapshotChecksum(hash, section.data, whole);
+            if (whole != section.size) {
+                char tail[8] = {};
+                std::memcpy(tail, section.data + whole, section.size - whole);
+                hash = snapshotChecksum(hash, tail, 8);
+            }
+        }
+        return hash;
+    }
+
+    void write(std::ostream& out) const {
+        const char zeros[8] = {};
+        for (const auto& section : m_sections) {
+            out.write(section.data, static_cast<std::streamsize>(section.size));
+            out.write(zeros, static_cast<std::streamsize>(paddedSize(section.size) - section.size));
+        }
+    }
+
+private:
+    struct Section {
+        const char* data;
+        std::size_t size;
+    };
+    std::vector<Section> m_sections;
+};
+
+// Walks the payload of a mapped snapshot, checking bounds on every step
+class SnapshotReader {
+public:
+    explicit SnapshotReader(std::string_view payload) : m_payload(payload), m_pos(0) {}
+
+    std::string_view take(std::size_t size) {
+        if (size > m_payload.size() - m_pos || paddedSize(size) > m_payload.size() - m_pos) {
+            throw std::runtime_error("Truncated snapshot");
+        }
+        std::string_view section = m_payload.substr(m_pos, size);
+        m_pos += paddedSize(size);
+        return section;
+    }
+
+    template<typename T>
+    std::vector<T> takeArray(std::uint64_t count) {
+        if (count > m_payload.size() / sizeof(T)) {
+            throw std::runtime_error("Truncated snapshot");
+        }
+        std::string_view section = take(static_cast<std::size_t>(count) * sizeof(T));
+        std::vector<T> values(static_cast<std::size_t>(count));
+        std::memcpy(values.data(), section.data(), section.size());
+        return values;
+    }
+
+    StringColumn takeStringColumn(std::uint64_t rowCount) {
+        if (rowCount >= m_payload.size()) {
+            throw std::runtime_error("Truncated snapshot"); // Also keeps rowCount + 1 from overflowing
+        }
+        std::vector<std::uint64_t> offsets = takeArray<std::uint64_t>(rowCount + 1);
+        std::string_view bytes = take(static_cast<std::size_t>(offsets.back()));
+        StringColumn column;
+        column.assign(bytes, std::vector<std::size_t>(offsets.begin(), offsets.end()));
+        return column;
+    }
+
+private:
+    std::string_view m_payload;
+    std::size_t m_pos;
+};
+
+} // namespace
+
+void writeSnapshot(const ContactColumns& columns, std::ostream& out) {
+    // Build the company dictionary; interned values make equal companies share one view
+    std::vector<std::string_view> dictionary;
+    std::vector<std::uint32_t> companyIndex;
+    companyIndex.reserve(columns.size());
+    std::unordered_map<std::string_view, std::uint32_t> dictionaryIds;
+    for (std::string_view company : columns.m_companies) {
+        auto inserted = dictionaryIds.emplace(company, static_cast<std::uint32_t>(dictionary.size()));
+        if (inserted.second) {
+            dictionary.push_back(company);
+        }
+        companyIndex.push_back(inserted.first->second);
+    }
+    StringColumn dictionaryColumn;
+    for (std::string_view company : dictionary) {
+        dictionaryColumn.append(company);
+    }
+
+    std::vector<std::uint64_t> nameOffsets = toU64(columns.m_names.offsets());
+    std::vector<std::uint64_t> phoneOffsets = toU64(columns.m_phones.offsets());
+    std::vector<std::uint64_t> emailOffsets = toU64(columns.m_emails.offsets());
+    std::vector<std::uint64_t> dictionaryOffsets = toU64(dictionaryColumn.offsets());
+
+    SnapshotWriter writer;
+    writer.add(columns.m_kinds.data(), columns.m_kinds.size());
+    writer.add(nameOffsets.data(), nameOffsets.size() * sizeof(std::uint64_t));
+    writer.add(columns.m_names.bytes().data(), columns.m_names.bytes().size());
+    writer.add(phoneOffsets.data(), phoneOffsets.size() * sizeof(std::uint64_t));
+    writer.add(columns.m_phones.bytes().data(), columns.m_phones.bytes().size());
+    writer.add(emailOffsets.data(), emailOffsets.size() * sizeof(std::uint64_t));
+    writer.add(columns.m_emails.bytes().data(), columns.m_emails.bytes().size());
+    writer.add(dictionaryOffsets.data(), dictionaryOffsets.size() * sizeof(std::uint64_t));
+    writer.add(dictionaryColumn.bytes().data(), dictionaryColumn.bytes().size());
+    writer.add(companyIndex.data(), companyIndex.size() * sizeof(std::uint32_t));
+
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+    header.version = snapshotVersion;
+    header.byteOrderMark = snapshotByteOrderMark;
+    header.rowCount = columns.size();
+    header.companyCount = dictionary.size();
+    header.payloadSize = writer.payloadSize();
+    header.checksum = writer.checksum();
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writer.write(out);
+    if (!out) {
+        throw std::runtime_error("Unable to write snapshot");
+    }
+}
+
+void readSnapshot(std::string_view image, ContactColumns& columns) {
+    SnapshotHeader header;
+    if (image.size() < sizeof(header)) {
+        throw std::runtime_error("Not a contact snapshot");
+    }
+    std::memcpy(&header, image.data(), sizeof(header));
+    if (std::memcmp(header.magic, snapshotMagic, sizeof(snapshotMagic)) != 0) {
+        throw std::runtime_error("Not a contact snapshot");
+    }
+    if (header.byteOrderMark != snapshotByteOrderMark) {
+        throw std::runtime_error("Snapshot was written with a different byte order");
+    }
+    if (header.version != snapshotVersion) {
+        throw std::runtime_error("Unsupported snapshot version");
+    }
+    std::string_view payload = image.substr(sizeof(header));
+    if (header.payloadSize != payload.size() || payload.size() % 8 != 0) {
+        throw std::runtime_error("Truncated snapshot");
+    }
+    if (snapshotChecksum(snapshotChecksumSeed, payload.data(), payload.size()) != header.checksum) {
+        throw std::runtime_error("Snapshot checksum mismatch");
+    }
+
+    SnapshotReader reader(payload);
+    std::vector<ContactKind> kinds = reader.takeArray<ContactKind>(header.rowCount);
+    for (ContactKind kind : kinds) {
+        if (kind != ContactKind::Personal && kind != ContactKind::Business) {
+            throw std::runtime_error("Invalid contact kind in snapshot");
+        }
+    }
+    StringColumn names = reader.takeStringColumn(header.rowCount);
+    StringColumn phones = reader.takeStringColumn(header.rowCount);
+    StringColumn emails = reader.takeStringColumn(header.rowCount);
+    StringColumn dictionary = reader.takeStringColumn(header.companyCount);
+    std::vector<std::uint32_t> companyIndex = reader.takeArray<std::uint32_t>(header.rowCount);
+
+    // Intern each distinct company once, then resolve the per-row indexes
+    ContactColumns loaded;
+    std::vector<std::string_view> companies;
+    companies.reserve(dictionary.size());
+    for (std::size_t i = 0; i < dictionary.size(); ++i) {
+        companies.push_back(loaded.m_companyPool.intern(dictionary.get(i)));
+    }
+    loaded.m_companies.reserve(companyIndex.size());
+    for (std::uint32_t index : companyIndex) {
+        if (index >= companies.size()) {
+            throw std::runtime_error("Invalid company index in snapshot");
+        }
+        loaded.m_companies.push_back(companies[index]);
+    }
+    loaded.m_names = std::move(names);
+    loaded.m_phones = std::move(phones);
+    loaded.m_emails = std::move(emails);
+    loaded.m_kinds = std::move(kinds);
+    columns = std::move(loaded);
+}
+
+} // namespace contact_management
@@ -0,0 +1,89 @@
+// ContactColumns.hpp
+#ifndef CONTACT_COLUMNS_H
+#define CONTACT_COLUMNS_H
+
+#include "Contact.hpp"
+#include "StringPool.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iosfwd>
+#include <cstddef>
+
+namespace contact_management { // Everything in a self-made namespace
+
+// One string field for all rows, stored back to back in a single buffer
+class StringColumn {
+public:
+    StringColumn();
+
+    void clear();
+    void reserve(std::size_t rows, std::size_t bytes);
+    void append(std::string_view value);
+
+    std::size_t size() const { return m_offsets.size() - 1; }
+    std::string_view get(std::size_t row) const {
+        return std::string_view(m_data.data() + m_offsets[row], m_offsets[row + 1] - m_offsets[row]);
+    }
+
+    // Raw storage, used by the binary snapshot code
+    std::string_view bytes() const { return m_data; }
+    const std::vector<std::size_t>& offsets() const { return m_offsets; }
+    // Replace the contents, throws std::runtime_error if offsets don't describe bytes
+    void assign(std::string_view bytes, std::vector<std::size_t> offsets);
+
+private:
+    std::string m_data;                // All values, concatenated
+    std::vector<std::size_t> m_offsets; // Row i spans [m_offsets[i], m_offsets[i + 1])
+};
+
+// Columnar (structure-of-arrays) copy of a contact list.
+// Row ids are positions: row i always describes the i-th contact that was appended.
+class ContactColumns;
+
+// Binary snapshot of a ContactColumns table (format described in ContactColumns.cpp)
+void writeSnapshot(const ContactColumns& columns, std::ostream& out);
+// Parse a snapshot image such as a MappedFile, throws std::runtime_error if it's invalid or corrupt
+void readSnapshot(std::string_view image, ContactColumns& columns);
+
+class ContactColumns {
+public:
+    using RowId = std::size_t;
+
+    void clear();
+    void reserve(std::size_t rows);
+    RowId append(const Contact& contact);
+    RowId append(std::string_view name, std::string_view phone, std::string_view email,
+                 std::string_view company, ContactKind kind);
+
+    std::size_t size() const { return m_kinds.size(); }
+    bool empty() const { return m_kinds.empty(); }
+
+    std::string_view name(RowId row) const { return m_names.get(row); }
+    std::string_view phone(RowId row) const { return m_phones.get(row); }
+    std::string_view email(RowId row) const { return m_emails.get(row); }
+    std::string_view company(RowId row) const { return m_companies[row]; }
+    ContactKind kind(RowId row) const { return m_kinds[row]; }
+
+    // Direct column access for tight scans
+    const StringColumn& names() const { return m_names; }
+    const StringColumn& phones() const { return m_phones; }
+    const StringColumn& emails() const { return m_emails; }
+    const std::vector<std::string_view>& companies() const { return m_companies; }
+    const std::vector<ContactKind>& kinds() const { return m_kinds; }
+
+private:
+    friend void writeSnapshot(const ContactColumns& columns, std::ostream& out);
+    friend void readSnapshot(std::string_view image, ContactColumns& columns);
+
+    StringColumn m_names;
+    StringColumn m_phones;
+    StringColumn m_emails;
+    std::vector<std::string_view> m_companies; // Interned: rows of the same company share one copy
+    StringPool m_companyPool;
+    std::vector<ContactKind> m_kinds;
+};
+
+} // namespace contact_management
+
+#endif // CONTACT_COLUMNS_H
@@ -0,0 +1,280 @@
+// ContactJournal.cpp
+#include "ContactJournal.hpp"
+#include "MappedFile.hpp"
+#include "FileUtils.hpp"
+#include <cstring>
+#include <stdexcept>
+
+namespace contact_management { // Everything in a self-made namespace
+
+// File layout: 8-byte magic, u64 base size, u64 base hash, then records.
+// Record layout: u32 body length, u32 body checksum, body.
+// Body: u8 operation, then for Add: u8 kind and u32-length-prefixed name, phone, email (and company
+// for business contacts); for Remove / SetFavorite: u64 index. Integers are in host byte order.
+
+namespace {
+
+const char journalMagic[8] = {'C', 'M', 'J', 'R', 'N', 'L', '\0', '\2'}; // Version 2: Remove swaps the last contact into the gap
+const std::size_t journalHeaderSize = 24;
+
+std::uint32_t journalChecksum(const char* data, std::size_t size) {
+    std::uint32_t hash = 2166136261u; // FNV-1a
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+    }
+    return hash;
+}
+
+template<typename T>
+void putInteger(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void putString(std::string& out, std::string_view value) {
+    putInteger(out, static_cast<std::uint32_t>(value.size()));
+    out.append(value.data(), value.size());
+}
+
+// Bounds-checked decoding of one record body
+class BodyReader {
+public:
+    explicit BodyReader(std::string_view body) : m_body(body), m_pos(0) {}
+
+    template<typename T>
+    T getInteger() {
+        if (m_body.size() - m_pos < sizeof(T)) {
+            throw std::runtime_error("Corrupt journal record");
+        }
+        T value;
+        std::memcpy(&value, m_body.data() + m_pos, sizeof(T));
+        m_pos += sizeof(T);
+        return value;
+    }
+
+    std::string getString() {
+        std::uint32_t size = getInteger<std::uint32_t>();
+        if (m_body.size() - m_pos < size) {
+            throw std::runtime_error("Corrupt journal record");
+        }
+        std::string value(m_body.substr(m_pos, size));
+        m_pos += size;
+        return value;
+    }
+
+private:
+    std::string_view m_body;
+    std::size_t m_pos;
+};
+
+ContactJournal::Entry decodeEntry(std::string_view body) {
+    BodyReader reader(body);
+    ContactJournal::Entry entry{};
+    entry.operation = static_cast<ContactJournal::Operation>(reader.getInteger<unsigned char>());
+    switch (entry.operation) {
+        case ContactJournal::Operation::Add:
+            entry.kind = static_cast<ContactKind>(reader.getInteger<unsigned char>());
+            entry.name = reader.getString();
+            entry.phone = reader.getString();
+            entry.email = reader.getString();
+            if (entry.kind == ContactKind::Business) {
+                entry.company = reader.getString();
+            }
+            break;
+        case ContactJournal::Operation::Remove:
+        case ContactJournal::Operation::SetFavorite:
+            entry.index = reader.getInteger<std::uint64_t>();
+            break;
+        case ContactJournal::Operation::ClearFavorite:
+            break;
+        default:
+            throw std::runtime_error("Corrupt journal record");
+    }
+    return entry;
+}
+
+} // namespace
+
+ContactJournal::BaseFingerprint ContactJournal::fingerprint(const std::string& filename) {
+    BaseFingerprint result = {0, 0xcbf29ce484222325ULL};
+    if (!std::ifstream(filename).good()) {
+        return result;
+    }
+    MappedFile file(filename);
+    std::string_view data = file.data();
+    result.size = data.size();
+    // FNV-1a style over 64-bit words, then the tail bytes
+    std::size_t whole = data.size() & ~static_cast<std::size_t>(7);
+    for (std::size_t i = 0; i < whole; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data.data() + i, 8);
+        result.hash = (result.hash ^ word) * 0x100000001b3ULL;
+    }
+    for (std::size_t i = whole; i < data.size(); ++i) {
+        result.hash = (result.hash ^ static_cast<unsigned char>(data[i])) * 0x100000001b3ULL;
+    }
+    return result;
+}
+
+ContactJournal::ContactJournal(const std::string& filename)
+    : m_filename(filename), m_pendingFilename(filename + ".tmp"), m_isPending(false), m_size(0), m_isActive(false) {}
+
+void ContactJournal::restart() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_file.close();
+    m_file.clear();
+    m_file.open(m_pendingFilename, std::ios::binary | std::ios::trunc);
+    m_isPending = true;
+    if (!m_file) {
+        m_isActive = false;
+        throw std::runtime_error("Unable to open journal for writing");
+    }
+    // The base isn't known yet; a zeroed fingerprint never matches a real file (its hash is never 0 with size 0)
+    char header[journalHeaderSize] = {};
+    std::memcpy(header, journalMagic, sizeof(journalMagic));
+    m_file.write(header, sizeof(header));
+    m_size = 0;
+    m_isActive = true;
+}
+
+void ContactJournal::stampBase(const BaseFingerprint& base) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_file.seekp(sizeof(journalMagic));
+    m_file.write(reinterpret_cast<const char*>(&base.size), sizeof(base.size));
+    m_file.write(reinterpret_cast<const char*>(&base.hash), sizeof(base.hash));
+    m_file.seekp(0, std::ios::end);
+    m_file.flush();
+    if (!m_file) {
+        throw std::runtime_error("Unable to write journal");
+    }
+    syncFile(m_pendingFilename); // Must be durable before the base replaces the old one
+}
+
+void ContactJournal::commit() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_file.close();
+    m_file.clear();
+    replaceFile(m_pendingFilename, m_filename);
+    m_isPending = false;
+    m_file.open(m_filename, std::ios::binary | std::ios::app); // Keep appending to the same data under its final name
+    if (!m_file) {
+        m_isActive = false;
+        throw std::runtime_error("Unable to open journal for writing");
+    }
+}
+
+void ContactJournal::deactivate() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isActive = false; // Keep the file open: a rebase in progress still commits what was recorded so far
+}
+
+bool ContactJournal::isActive() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_isActive;
+}
+
+void ContactJournal::append(const std::string& body) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_isActive) {
+        return;
+    }
+    std::uint32_t header[2] = {static_cast<std::uint32_t>(body.size()), journalChecksum(body.data(), body.size())};
+    m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    m_file.write(body.data(), static_cast<std::streamsize>(body.size()));
+    m_size += sizeof(header) + body.size();
+}
+
+void ContactJournal::recordAdd(const Contact& contact) {
+    std::string body;
+    putInteger(body, static_cast<unsigned char>(Operation::Add));
+    putInteger(body, static_cast<unsigned char>(contact.getKind()));
+    putString(body, contact.getNameView());
+    putString(body, contact.getPhoneView());
+    putString(body, contact.getEmailView());
+    if (contact.isBusiness()) {
+        putString(body, contact.getCompanyView());
+    }
+    append(body);
+}
+
+void ContactJournal::recordRemove(std::uint64_t index) {
+    std::string body;
+    putInteger(body, static_cast<unsigned char>(Operation::Remove));
+    putInteger(body, index);
+    append(body);
+}
+
+void ContactJournal::recordSetFavorite(std::uint64_t index) {
+    std::string body;
+    putInteger(body, static_cast<unsigned char>(Operation::SetFavorite));
+    putInteger(body, index);
+    append(body);
+}
+
+void ContactJournal::recordClearFavorite() {
+    std::string body;
+    putInteger(body, static_cast<unsigned char>(Operation::ClearFavorite));
+    append(body);
+}
+
+void ContactJournal::flush() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_isActive) {
+        return;
+    }
+    m_file.flush();
+    try {
+        if (!m_file) {
+            throw std::runtime_error("Unable to write journal");
+        }
+        syncFile(m_isPending ? m_pendingFilename : m_filename);
+    } catch (...) {
+        m_isActive = false;
+        throw;
+    }
+}
+
+std::uint64_t ContactJournal::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_size;
+}
+
+bool ContactJournal::readEntries(const std::string& filename, const BaseFingerprint& base, std::vector<Entry>& entries) {
+    entries.clear();
+    if (!std::ifstream(filename).good()) {
+        return false;
+    }
+    MappedFile file(filename);
+    std::string_view data = file.data();
+    if (data.size() < journalHeaderSize || std::memcmp(data.data(), journalMagic, sizeof(journalMagic)) != 0) {
+        return false;
+    }
+    BaseFingerprint journalBase;
+    std::memcpy(&journalBase.size, data.data() + 8, 8);
+    std::memcpy(&journalBase.hash, data.data() + 16, 8);
+    if (!(journalBase == base)) {
+        return false;
+    }
+
+    std::size_t pos = journalHeaderSize;
+    while (data.size() - pos >= 8) {
+        std::uint32_t size, checksum;
+        std::memcpy(&size, data.data() + pos, 4);
+        std::memcpy(&checksum, data.data() + pos + 4, 4);
+        if (data.size() - pos - 8 < size) {
+            break; // Torn tail
+        }
+        std::string_view body = data.substr(pos + 8, size);
+        if (journalChecksum(body.data(), body.size()) != checksum) {
+            break; // Corrupt tail, nothing after it can be trusted
+        }
+        try {
+            entries.push_back(decodeEntry(body));
+        } catch (const std::runtime_error&) {
+            break;
+        }
+        pos += 8 + size;
+    }
+    return true;
+}
+
+} // namespace contact_management
@@ -0,0 +1,95 @@
+// ContactJournal.hpp
+#ifndef CONTACT_JOURNAL_H
+#define CONTACT_JOURNAL_H
+
+#include "Contact.hpp"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+
+namespace contact_management { // Everything in a self-made namespace
+
+// Append-only log of contact mutations made since the last full save (the "base").
+// Replaying the base and then the journal entries in order reproduces the current contacts.
+// The file starts with a fingerprint of its base, so it is never replayed on top of another one.
+class ContactJournal {
+public:
+    enum class Operation : unsigned char {
+        Add = 1,
+        Remove = 2,
+        SetFavorite = 3,
+        ClearFavorite = 4
+    };
+
+    // One decoded journal record
+    struct Entry {
+        Operation operation;
+        ContactKind kind;       // Add only
+        std::string name;       // Add only
+        std::string phone;      // Add only
+        std::string email;      // Add only
+        std::string company;    // Add of a business contact only
+        std::uint64_t index;    // Remove / SetFavorite only
+    };
+
+    // Identifies the base file a journal applies to
+    struct BaseFingerprint {
+        std::uint64_t size;
+        std::uint64_t hash;
+        bool operator==(const BaseFingerprint& other) const { return size == other.size && hash == other.hash; }
+    };
+    static BaseFingerprint fingerprint(const std::string& filename); // A missing file counts as empty
+
+    explicit ContactJournal(const std::string& filename);
+
+    // Rebasing onto a new full save, in this order:
+    //   restart()    - while no mutation can run, right after taking the snapshot that becomes the new base;
+    //                  later records go to a side file (<filename>.tmp) and recording is (re)activated
+    //   stampBase()  - once the new base is written (not yet renamed into place), records its fingerprint
+    //   commit()     - once the base is in place, moves the side file over the journal
+    // A crash between the steps leaves either the old base + old journal or the new base + side file.
+    void restart();
+    void stampBase(const BaseFingerprint& base);
+    void commit();
+    // Stop recording: the contacts no longer derive from the last base (e.g. after a reload)
+    void deactivate();
+    bool isActive() const;
+
+    // Record a mutation (no-op while inactive)
+    void recordAdd(const Contact& contact);
+    void recordRemove(std::uint64_t index);
+    void recordSetFavorite(std::uint64_t index);
+    void recordClearFavorite();
+
+    // Write buffered records and sync them to disk. Throws std::runtime_error if either fails, and stops
+    // recording then: the file may have lost records, so only a new base (restart()) makes it usable again.
+    void flush();
+
+    // Bytes recorded since the last reset
+    std::uint64_t size() const;
+
+    const std::string& getFilename() const { return m_filename; }
+
+    const std::string& getPendingFilename() const { return m_pendingFilename; }
+
+    // Read all complete records of a journal file into entries; a torn or corrupt tail (crash mid-write)
+    // is ignored. Returns false, leaving entries empty, if the file is missing or belongs to another base.
+    static bool readEntries(const std::string& filename, const BaseFingerprint& base, std::vector<Entry>& entries);
+
+private:
+    void append(const std::string& body);
+
+    std::string m_filename;
+    std::string m_pendingFilename; // Side file written between restart() and commit()
+    std::ofstream m_file;
+    bool m_isPending; // m_file is the side file, between restart() and commit()
+    std::uint64_t m_size;
+    bool m_isActive;
+    mutable std::mutex m_mutex; // Records may come from the UI thread while autosave flushes
+};
+
+} // namespace contact_management
+
+#endif // CONTACT_JOURNAL_H
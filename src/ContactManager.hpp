@@ -3,6 +3,15 @@
 #define CONTACT_MANAGER_H
 
 #include "Contact.hpp"
+#include "ContactColumns.hpp"
+#include "ContactJournal.hpp"
+#include "CowVector.hpp"
+#include "SlotMap.hpp"
+#include "IdIndex.hpp"
+#include "SortedBlocks.hpp"
+#include "FuzzySearch.hpp"
+#include "ContactQuery.hpp"
+#include "OutputBuffer.hpp"
 #include <vector>
 #include <memory>
 #include <fstream>
@@ -11,12 +20,42 @@
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <string_view>
 #include "../external/json.hpp"
 
 namespace contact_management { // Everything in a self-made namespace
 using json = nlohmann::json;
 
 
+// When the background auto-save writes pending edits. A save happens once any enabled trigger fires,
+// but never sooner than minInterval after the previous one. Zero disables a trigger.
+struct AutoSavePolicy {
+    std::chrono::milliseconds maxLatency{30000}; // Longest an edit stays unsaved (bounds the data-loss window)
+    std::chrono::milliseconds debounce{0};       // Save once edits have paused this long (coalesces bursts)
+    std::size_t maxDirtyCount = 0;               // Save as soon as this many edits are pending
+    std::size_t maxDirtyBytes = 0;               // Save as soon as edits touching this many bytes are pending
+    std::chrono::milliseconds minInterval{0};    // Rate limit between two saves
+    std::uint64_t journalCompactionBytes = 4 * 1024 * 1024; // Rewrite the full file instead of only the journal past this size
+};
+
+// How an import treats a contact whose email or phone (compared as findByEmail / findByPhone do)
+// matches one imported before it or already in the list
+enum class DuplicatePolicy {
+    Keep,  // Add it anyway
+    Skip,  // Keep the existing contact, drop the new one
+    Merge  // Replace the contacts matching its email and its phone by the new one, with its empty fields
+           // taken from them (the email match first), so no two contacts end up sharing either key
+};
+
+// Stable handle for a contact, valid until the contact is removed or the contacts are replaced by a load
+using ContactId = SlotId;
+
+// All public member functions may be called from several threads at once: queries share a
+// reader lock, mutations take it exclusively, and loaders parse before taking any lock.
 class ContactManager {
 public:
     // Default constructor
@@ -28,62 +67,287 @@ public:
     // Destructor
     ~ContactManager();
 
-    // Add a new contact
-    void addContact(std::shared_ptr<Contact> contact); // Shared pointer for dynamic memory allocation
+    // Add a new contact. Contacts are immutable once added: every index is keyed on their fields, so
+    // callers must not keep changing the object they passed in (remove it and add an edited copy instead)
+    ContactId addContact(std::shared_ptr<const Contact> contact); // Shared pointer for dynamic memory allocation
     
-    // Remove a contact by index
-    void removeContact(unsigned char index); // Unsigned char for better memory efficiency
+    // Remove a contact by index; the last contact takes its place, so nothing shifts
+    void removeContact(std::size_t index);
+
+    // Id-based access, O(1). Unknown or removed ids throw std::out_of_range (findContactById returns null)
+    std::shared_ptr<const Contact> findContactById(ContactId id) const;
+    void removeContactById(ContactId id);
+    void setFavoriteContactById(ContactId id);
+    ContactId getContactId(std::size_t index) const;
+    std::vector<ContactId> getContactIds() const; // Same order as getAllContacts
+
+    // Collects additions and removals and applies them in one go: a single lock and one index /
+    // favorite / auto-save update. Removal indexes refer to the contacts as they are at commit,
+    // additions are appended after the removals. Nothing is applied if the batch is destroyed
+    // without commit().
+    class Batch {
+    public:
+        explicit Batch(ContactManager& manager) : m_manager(manager) {}
+
+        void add(std::shared_ptr<const Contact> contact) { m_added.push_back(std::move(contact)); }
+        void remove(std::size_t index) { m_removed.push_back(index); }
+        void removeById(ContactId id) { m_removedIds.push_back(id); }
+
+        // Returns the ids of the added contacts. Throws std::out_of_range, leaving the contacts
+        // unchanged, if a removal index or id is invalid.
+        std::vector<ContactId> commit();
+
+    private:
+        ContactManager& m_manager;
+        std::vector<std::shared_ptr<const Contact>> m_added;
+        std::vector<std::size_t> m_removed;
+        std::vector<ContactId> m_removedIds;
+    };
+    Batch beginBatch() { return Batch(*this); }
+
+    // Bulk versions of addContact / removeContact, linear in the number of contacts
+    std::vector<ContactId> addContacts(std::vector<std::shared_ptr<const Contact>> contacts);
+    void removeContacts(std::vector<std::size_t> indexes);
+    void removeContactsById(const std::vector<ContactId>& ids);
     
-    // Display all contacts
-    void displayAllContacts() const; // Renamed to avoid confusion
+    // Display all contacts, Tsv / Csv print a header row then one row per contact
+    void displayAllContacts(OutputFormat format = OutputFormat::Plain) const; // Renamed to avoid confusion
     
     // Save contacts to a file
     void saveToFile(const std::string& filename) const; // Const reference for function parameter and const member function
     
     // Load contacts from a file
-    void loadFromFile(const std::string& filename); // Const reference for function parameter
+    void loadFromFile(const std::string& filename, DuplicatePolicy duplicates = DuplicatePolicy::Keep); // Const reference for function parameter
+
+    // Same result as loadFromFile, records are parsed on threadCount threads (0 = one per core)
+    void loadFromFileParallel(const std::string& filename, unsigned threadCount = 0, DuplicatePolicy duplicates = DuplicatePolicy::Keep);
 
     // Find contacts by name
-    std::vector<std::shared_ptr<Contact>> findContactsByName(const std::string& name) const; // Const reference for function parameter and const member function
+    std::vector<std::shared_ptr<const Contact>> findContactsByName(const std::string& name) const; // Const reference for function parameter and const member function
+
+    // Hash index lookups. Emails compare ignoring ASCII case and surrounding spaces, phones by their
+    // digits and a leading '+' only, so "+1 (555) 010-0199" finds "+15550100199"
+    std::vector<std::shared_ptr<const Contact>> findByEmail(const std::string& email) const;
+    std::vector<std::shared_ptr<const Contact>> findByPhone(const std::string& phone) const;
+    std::vector<std::shared_ptr<const Contact>> findByCompany(const std::string& company) const; // Business contacts, exact match
+
+    // Contacts ordered by a field (equal keys in an unspecified but fixed order), served from sorted
+    // indexes built on first use: O(log n + k) once built (page adds O(n / 1024) to find its offset), and
+    // each later add / remove costs O(log n) plus moving at most a thousand entries per built index
+    std::vector<std::shared_ptr<const Contact>> rangeByName(const std::string& from, const std::string& to) const; // from <= name < to
+    std::vector<std::shared_ptr<const Contact>> page(std::size_t offset, std::size_t limit, ContactField order = ContactField::Name) const;
+    void displayPage(std::size_t offset, std::size_t limit, ContactField order = ContactField::Name,
+                     OutputFormat format = OutputFormat::Plain) const;
+
+    // Find contacts whose name / phone starts with the given prefix (sorted index, O(log n + k))
+    std::vector<std::shared_ptr<const Contact>> findByNamePrefix(const std::string& prefix) const;
+    std::vector<std::shared_ptr<const Contact>> findByPhonePrefix(const std::string& prefix) const;
 
 // New function to filter contacts
-    std::vector<std::shared_ptr<Contact>> filterContacts(const std::function<bool(const Contact&)>& filter) const;
+    std::vector<std::shared_ptr<const Contact>> filterContacts(const std::function<bool(const Contact&)>& filter) const;
+
+    // Contacts matching query, in list order. Answered from the name index or an already built sorted
+    // index when the query pins a field down, otherwise by a scan over the columns
+    std::vector<std::shared_ptr<const Contact>> findContacts(const ContactQuery& query) const;
+
+    // Closest contacts by edit distance (ASCII case folded) from query to their name or email, whichever
+    // is closer: at most limit of them, all within maxDistance, nearest first and ties in list order.
+    // Candidates come from a trigram index built on the first call and kept up to date afterwards.
+    struct FuzzyMatch {
+        std::shared_ptr<const Contact> contact;
+        unsigned distance;
+    };
+    std::vector<FuzzyMatch> findFuzzy(const std::string& query, unsigned maxDistance = 2, std::size_t limit = 10) const;
+
+    // Contacts whose field contains needle (ASCII case folding if asked), in list order. A vectorized scan
+    // over the field's contiguous bytes, split across threadCount threads (0 = one per core) for large lists
+    std::vector<std::shared_ptr<const Contact>> findContaining(ContactField field, const std::string& needle,
+                                                         bool caseInsensitive = false, unsigned threadCount = 0) const;
 
     // New function to get contact count
-    uint16_t  getContactCount() const { return m_contacts.size(); }
+    std::size_t getContactCount() const;
 
         // New methods for favorite contact
-    void setFavoriteContact(unsigned char index);
+    void setFavoriteContact(std::size_t index);
     void clearFavoriteContact();
-    const Contact* getFavoriteContact() const;
+    std::shared_ptr<const Contact> getFavoriteContact() const; // Shared, so it stays valid if the contact is removed meanwhile
 
-    void exportToJson(const std::string& filename) const;
-    void importFromJson(const std::string& filename);
+    // Binary snapshot (versioned header, column layout, checksum), much faster to write and load than text or JSON
+    void saveSnapshot(const std::string& filename) const;
+    void loadSnapshot(const std::string& filename);
+
+    // Streamed out contact by contact; compact drops the indentation and newlines
+    void exportToJson(const std::string& filename, bool compact = false) const;
+    void importFromJson(const std::string& filename, DuplicatePolicy duplicates = DuplicatePolicy::Keep);
+
+    // Import a JSON Lines file (one contact object per line), parsed on threadCount threads (0 = one per core)
+    void importFromJsonLines(const std::string& filename, unsigned threadCount = 0, DuplicatePolicy duplicates = DuplicatePolicy::Keep);
+    // Write every contact as one JSON line, append adds them to the end of an existing file
+    void exportToJsonLines(const std::string& filename, bool append = false) const;
+    // Add the contacts on the complete lines from byte offset onwards to the current ones.
+    // Returns the offset to resume from next time (an unfinished last line is left for then).
+    // Duplicates are checked against the current contacts too; a merged contact moves to the end.
+    std::size_t appendFromJsonLines(const std::string& filename, std::size_t offset, unsigned threadCount = 0,
+                                    DuplicatePolicy duplicates = DuplicatePolicy::Keep);
     void setModified();
 
-    const std::vector<std::shared_ptr<Contact>>& getAllContacts() const;
+    // Whether an earlier session (or this one) left an auto-save behind
+    bool hasAutoSave() const;
+    // Replace the contacts by the auto-saved state: load the last full auto-save, then replay the journal
+    // written after it, favorite included. Returns false, changing nothing, if there is no auto-save.
+    bool recoverFromAutoSave();
+    // Change when the background auto-save runs; takes effect immediately
+    void setAutoSavePolicy(const AutoSavePolicy& policy);
+    AutoSavePolicy getAutoSavePolicy() const;
+
+    // Returns a copy, so it stays valid while other threads modify the manager. The contacts are
+    // shared with the manager and read-only for that reason
+    std::vector<std::shared_ptr<const Contact>> getAllContacts() const;
+
+    // Call visitor with the columnar copy of the contacts (row i == getAllContacts()[i]) while holding the
+    // reader lock; the columns are rebuilt lazily after changes and must not be used after visitor returns
+    template<typename Visitor>
+    void visitColumns(Visitor&& visitor) const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        visitor(columnsLocked());
+    }
+
+    // Kind-specialized bulk operations, they branch on the kind tag and never use RTTI
+    std::size_t countContacts(ContactKind kind) const; // Counted over the kind column
+    // Call personal(const Contact&) or business(const BusinessContact&) for every contact in list order,
+    // under the reader lock. Each visitor gets the concrete type, so calls on it aren't virtual.
+    template<typename PersonalVisitor, typename BusinessVisitor>
+    void visitContacts(PersonalVisitor&& personal, BusinessVisitor&& business) const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        for (const auto& contact : m_contacts) {
+            if (contact->isBusiness()) {
+                business(static_cast<const BusinessContact&>(*contact));
+            } else {
+                personal(*contact);
+            }
+        }
+    }
 
 
 
 private:
-    std::vector<std::shared_ptr<Contact>> m_contacts;
-    mutable bool m_isModified;  // New bool to track if contacts have been modified
+    mutable std::shared_mutex m_mutex; // Guards everything below except the atomics and m_journal
+    mutable std::mutex m_cacheMutex;   // Serializes lazy rebuilds of the derived data by concurrent readers
+
+    // Copy-on-write, so saves can take a snapshot under the lock in O(n / chunk size) and write it without the lock
+    using ContactList = CowVector<std::shared_ptr<const Contact>>;
+    ContactList m_contacts;
+    SlotMap m_ids; // m_ids.idAt(i) is the id of m_contacts[i]
+    mutable std::atomic<bool> m_isModified;  // New bool to track if contacts have been modified
     bool m_isLoaded;    // New bool to track if contacts have been loaded from a file
-    bool m_isSorted;    // New bool to track if contacts are sorted
-    std::shared_ptr<Contact> m_favoriteContact;  // New member variable
+    ContactId m_favoriteId;  // 0 (never a valid id) when there is no favorite
+    // Hash indexes, removing a contact from them is O(1) however many contacts share its key. Name and
+    // company keys view the stored contacts' own strings (contacts are immutable and unindexed before they
+    // are dropped), so they cost no string copies. Email and phone keys are normalized copies: those two are
+    // built by the first lookup that needs them and kept up to date from then on.
+    using ViewIndex = IdIndex<std::string_view>;
+    using KeyIndex = IdIndex<std::string>;
+    ViewIndex m_nameIndex;    // Exact-match name index for findContactsByName
+    ViewIndex m_companyIndex; // Business contacts with a company
+    mutable KeyIndex m_emailIndex; // Normalized email, contacts without one aren't in it
+    mutable KeyIndex m_phoneIndex; // Normalized phone, likewise
+    mutable bool m_hasEmailIndex;
+    mutable bool m_hasPhoneIndex;
+    const KeyIndex& keyIndexLocked(ContactField field) const; // Email or Phone; caller holds m_mutex (shared is enough)
+    bool hasKeyIndexLocked(ContactField field) const; // Already built, so using it costs no rebuild
+
+    // Sorted (key, id) lists, one per ContactField, each built on the first query that needs it and from then
+    // on kept sorted by every add and remove in O(log n + block size), see SortedBlocks. Keys view the stored
+    // contacts' strings; equal keys are ordered by id, so a removal finds its entry by binary search.
+    struct SortedEntry {
+        std::string_view key;
+        ContactId id;
+        bool operator<(const SortedEntry& other) const { return key < other.key || (key == other.key && id < other.id); }
+    };
+    using SortedIndex = SortedBlocks<SortedEntry>;
+    static const std::size_t sortedFieldCount = 4;
+    mutable SortedIndex m_sortedIndexes[sortedFieldCount];
+    mutable bool m_hasSortedIndex[sortedFieldCount];
+    const SortedIndex& sortedIndexLocked(ContactField field) const; // Caller holds m_mutex (shared is enough)
+    // Apply a batch's removals and additions (those at positions firstAdded onwards) to the built sorted
+    // indexes in one merge each; applyBatchLocked hides them from the per-contact upkeep meanwhile
+    void mergeSortedIndexesLocked(const bool (&built)[sortedFieldCount], std::vector<ContactId> removedIds, std::size_t firstAdded);
+    static std::pair<SortedIndex::const_iterator, SortedIndex::const_iterator> prefixRange(const SortedIndex& index, const std::string& prefix);
+    std::vector<std::shared_ptr<const Contact>> findByPrefixLocked(ContactField field, const std::string& prefix) const;
+    bool hasSortedIndexLocked(ContactField field) const; // Built and current, so using it costs no rebuild
+    // Rows that may match (a superset), taken from indexes; false when the query needs a scan
+    bool candidateRowsLocked(const ContactQuery& query, std::vector<std::size_t>& rows) const;
+
+    // Fuzzy search candidates, built on first use and then updated with each add; removed ids are
+    // skipped and the index is dropped once they outnumber the contacts
+    mutable TrigramIndex m_trigrams;
+    const TrigramIndex& trigramIndexLocked() const; // Caller holds m_mutex (shared is enough)
+
+    // Contiguous field storage for scans and saves. A rebuild makes a new one instead of refilling this one,
+    // so a save can keep writing the copy it took after releasing the lock.
+    mutable std::shared_ptr<const ContactColumns> m_columns;
+    mutable bool m_columnsDirty;
+    void markDerivedDataStale(); // Columns are rebuilt on next use
+    std::shared_ptr<const ContactColumns> sharedColumnsLocked() const; // Caller holds m_mutex (shared is enough)
+    const ContactColumns& columnsLocked() const { return *sharedColumnsLocked(); } // Valid while the lock is held
+
+    ContactJournal m_journal; // Mutations since the last full auto-save
+    void compactAutoSave(); // Snapshot + journal restart under the lock, the file write runs without it
+
+    // Auto-save scheduler state, guarded by m_autoSaveMutex (taken after m_mutex, never before it)
+    using Clock = std::chrono::steady_clock;
+    mutable std::mutex m_autoSaveMutex;
+    std::condition_variable m_autoSaveWake; // Signalled on the first pending edit, crossed thresholds, policy changes and stop
+    AutoSavePolicy m_autoSavePolicy;
+    std::size_t m_pendingEdits;
+    std::size_t m_pendingBytes;
+    Clock::time_point m_firstPendingEdit;
+    Clock::time_point m_lastPendingEdit;
+    Clock::time_point m_lastAutoSave;
+    void noteMutation(std::size_t bytes, std::size_t edits = 1); // Record edits for auto-save and wake the thread if it's due
+    Clock::time_point nextAutoSaveTime() const; // Caller holds m_autoSaveMutex and there are pending edits
+
     std::thread m_autoSaveThread;
     std::atomic<bool> m_stopAutoSave;
     void autoSaveFunction();
     void startAutoSave();
     void stopAutoSave();
+
+    // Index maintenance, called whenever m_contacts changes
+    void indexContact(const Contact& contact, ContactId id);
+    void unindexContact(const Contact& contact, ContactId id);
+    void rebuildIndexes();
+    template<typename Index>
+    std::vector<std::shared_ptr<const Contact>> findInIndexLocked(const Index& index, const typename Index::key_type& key) const;
+    // Apply a duplicate policy to contacts about to be added: drops or merges them in place and lists the
+    // current rows merged into them in removed, for one applyBatchLocked
+    void resolveImportLocked(std::vector<std::shared_ptr<const Contact>>& contacts, DuplicatePolicy duplicates,
+                             std::vector<std::size_t>& removed) const;
+
+    // Unlocked implementations, the caller holds m_mutex exclusively
+    ContactId addContactLocked(std::shared_ptr<const Contact> contact);
+    void removeContactLocked(std::size_t index);
+    void eraseContactLocked(std::size_t index); // Swap-remove plus index / favorite / journal upkeep, no checks
+    void setFavoriteContactLocked(std::size_t index);
+    void clearFavoriteContactLocked();
+    std::size_t positionOfLocked(ContactId id) const; // Throws std::out_of_range for stale ids
+    std::vector<ContactId> applyBatchLocked(std::vector<std::shared_ptr<const Contact>>& added, std::vector<std::size_t>& removed);
+
+    // Swap in a freshly loaded contact list; columns is only given by loadSnapshot, which reads them directly
+    void replaceContactsLocked(std::vector<std::shared_ptr<const Contact>> contacts, ContactColumns* columns);
 };
 
+// Listing output: the header row (nothing for Plain) and one contact, Plain matches displayDetails plus a blank line
+void writeContactHeader(OutputBuffer& out, OutputFormat format);
+void writeContact(OutputBuffer& out, const Contact& contact, OutputFormat format);
+
 // Template function for displaying a container of contacts
 template<typename T>
-void displayContacts(const T& contacts) {
+void displayContacts(const T& contacts, OutputFormat format = OutputFormat::Plain) {
+    OutputBuffer out(std::cout); // Written in large blocks instead of a flush per line
+    writeContactHeader(out, format);
     for (const auto& contact : contacts) {
-        contact->displayDetails();
-        std::cout << std::endl;
+        writeContact(out, *contact, format);
     }
 }
 
@@ -0,0 +1,201 @@
+// ContactQuery.cpp
+#include "ContactQuery.hpp"
+#include "SubstringSearch.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace contact_management { // Everything in a self-made namespace
+
+namespace {
+
+struct EqualsMatch {
+    std::string_view value;
+    bool operator()(std::string_view field) const {
+        return field.size() == value.size() && std::memcmp(field.data(), value.data(), value.size()) == 0;
+    }
+};
+
+struct PrefixMatch {
+    std::string_view value;
+    bool operator()(std::string_view field) const {
+        return field.size() >= value.size() && std::memcmp(field.data(), value.data(), value.size()) == 0;
+    }
+};
+
+std::string_view fieldOf(const Contact& contact, ContactField field) {
+    switch (field) {
+        case ContactField::Name: return contact.getNameView();
+        case ContactField::Phone: return contact.getPhoneView();
+        case ContactField::Email: return contact.getEmailView();
+        case ContactField::Company: return contact.getCompanyView();
+    }
+    return std::string_view();
+}
+
+// The scans below are instantiated once per (test, column) pair, so the inner loop has no indirect calls.
+// Rows are handled 64 at a time and each result word is stored once.
+
+template<typename Match>
+void scanStringColumn(const StringColumn& column, Match match, std::vector<std::uint64_t>& bits) {
+    const char* data = column.bytes().data();
+    const std::size_t* offsets = column.offsets().data();
+    std::size_t rows = column.size();
+    for (std::size_t base = 0; base < rows; base += 64) {
+        std::size_t end = std::min(rows, base + 64);
+        std::uint64_t word = 0;
+        for (std::size_t row = base; row < end; ++row) {
+            std::string_view value(data + offsets[row], offsets[row + 1] - offsets[row]);
+            word |= static_cast<std::uint64_t>(match(value)) << (row - base);
+        }
+        bits[base / 64] = word;
+    }
+}
+
+template<typename Match>
+void scanViews(const std::vector<std::string_view>& column, Match match, std::vector<std::uint64_t>& bits) {
+    std::size_t rows = column.size();
+    for (std::size_t base = 0; base < rows; base += 64) {
+        std::size_t end = std::min(rows, base + 64);
+        std::uint64_t word = 0;
+        for (std::size_t row = base; row < end; ++row) {
+            word |= static_cast<std::uint64_t>(match(column[row])) << (row - base);
+        }
+        bits[base / 64] = word;
+    }
+}
+
+template<typename Match>
+void scanField(const ContactColumns& columns, ContactField field, Match match, std::vector<std::uint64_t>& bits) {
+    switch (field) {
+        case ContactField::Name: scanStringColumn(columns.names(), match, bits); break;
+        case ContactField::Phone: scanStringColumn(columns.phones(), match, bits); break;
+        case ContactField::Email: scanStringColumn(columns.emails(), match, bits); break;
+        case ContactField::Company: scanViews(columns.companies(), match, bits); break; // Empty for personal rows
+    }
+}
+
+} // namespace
+
+ContactQuery ContactQuery::equals(ContactField field, std::string value) {
+    return ContactQuery(std::make_shared<const Node>(Node{Op::Equals, field, std::move(value), {}}));
+}
+
+ContactQuery ContactQuery::prefix(ContactField field, std::string value) {
+    return ContactQuery(std::make_shared<const Node>(Node{Op::Prefix, field, std::move(value), {}}));
+}
+
+ContactQuery ContactQuery::contains(ContactField field, std::string value) {
+    return ContactQuery(std::make_shared<const Node>(Node{Op::Contains, field, std::move(value), {}}));
+}
+
+ContactQuery ContactQuery::isBusiness() {
+    return ContactQuery(std::make_shared<const Node>(Node{Op::IsBusiness, ContactField::Name, std::string(), {}}));
+}
+
+ContactQuery ContactQuery::combine(Op op, const ContactQuery& a, const ContactQuery& b) {
+    Node node{op, ContactField::Name, std::string(), {}};
+    // Flatten chains like a && b && c into one node
+    for (const ContactQuery* part : {&a, &b}) {
+        if (part->op() == op) {
+            node.children.insert(node.children.end(), part->children().begin(), part->children().end());
+        } else {
+            node.children.push_back(*part);
+        }
+    }
+    return ContactQuery(std::make_shared<const Node>(std::move(node)));
+}
+
+ContactQuery operator&&(const ContactQuery& a, const ContactQuery& b) {
+    return ContactQuery::combine(ContactQuery::Op::And, a, b);
+}
+
+ContactQuery operator||(const ContactQuery& a, const ContactQuery& b) {
+    return ContactQuery::combine(ContactQuery::Op::Or, a, b);
+}
+
+ContactQuery operator!(const ContactQuery& a) {
+    return ContactQuery(std::make_shared<const ContactQuery::Node>(
+        ContactQuery::Node{ContactQuery::Op::Not, ContactField::Name, std::string(), {a}}));
+}
+
+bool ContactQuery::matches(const Contact& contact) const {
+    switch (op()) {
+        case Op::Equals: return EqualsMatch{value()}(fieldOf(contact, field()));
+        case Op::Prefix: return PrefixMatch{value()}(fieldOf(contact, field()));
+        case Op::Contains: return SubstringSearcher(value(), false).contains(fieldOf(contact, field()));
+        case Op::IsBusiness: return contact.isBusiness();
+        case Op::And:
+            for (const ContactQuery& child : children()) {
+                if (!child.matches(contact)) {
+                    return false;
+                }
+            }
+            return true;
+        case Op::Or:
+            for (const ContactQuery& child : children()) {
+                if (child.matches(contact)) {
+                    return true;
+                }
+            }
+            return false;
+        case Op::Not: return !children().front().matches(contact);
+    }
+    return false;
+}
+
+std::vector<std::uint64_t> ContactQuery::evaluate(const ContactColumns& columns) const {
+    std::size_t rows = columns.size();
+    std::vector<std::uint64_t> bits((rows + 63) / 64, 0);
+    switch (op()) {
+        case Op::Equals: scanField(columns, field(), EqualsMatch{value()}, bits); break;
+        case Op::Prefix: scanField(columns, field(), PrefixMatch{value()}, bits); break;
+        case Op::Contains: {
+            SubstringSearcher searcher(value(), false);
+            if (field() == ContactField::Company) {
+                scanViews(columns.companies(), [&searcher](std::string_view company) { return searcher.contains(company); }, bits);
+            } else {
+                // One vectorized pass over the column's bytes rather than a search per value
+                const StringColumn& column = field() == ContactField::Name ? columns.names()
+                                           : field() == ContactField::Phone ? columns.phones() : columns.emails();
+                searcher.scanColumn(column, 0, rows, bits.data());
+            }
+            break;
+        }
+        case Op::IsBusiness: {
+            const std::vector<ContactKind>& kinds = columns.kinds();
+            for (std::size_t base = 0; base < rows; base += 64) {
+                std::size_t end = std::min(rows, base + 64);
+                std::uint64_t word = 0;
+                for (std::size_t row = base; row < end; ++row) {
+                    word |= static_cast<std::uint64_t>(kinds[row] == ContactKind::Business) << (row - base);
+                }
+                bits[base / 64] = word;
+            }
+            break;
+        }
+        case Op::And:
+        case Op::Or: {
+            bits = children().front().evaluate(columns);
+            for (std::size_t i = 1; i < children().size(); ++i) {
+                std::vector<std::uint64_t> other = children()[i].evaluate(columns);
+                for (std::size_t w = 0; w < bits.size(); ++w) {
+                    bits[w] = op() == Op::And ? bits[w] & other[w] : bits[w] | other[w];
+                }
+            }
+            break;
+        }
+        case Op::Not: {
+            bits = children().front().evaluate(columns);
+            for (std::uint64_t& word : bits) {
+                word = ~word;
+            }
+            if (rows % 64 != 0) {
+                bits.back() &= (std::uint64_t(1) << (rows % 64)) - 1; // Rows past the end never match
+            }
+            break;
+        }
+    }
+    return bits;
+}
+
+} // namespace contact_management
@@ -0,0 +1,91 @@
+// ContactQuery.hpp
+#ifndef CONTACT_QUERY_H
+#define CONTACT_QUERY_H
+
+#include "Contact.hpp"
+#include "ContactColumns.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace contact_management { // Everything in a self-made namespace
+
+// Filter expression for ContactManager::findContacts, built from field tests combined with && || !:
+//     ContactQuery::prefix(ContactField::Name, "Al") && !ContactQuery::isBusiness()
+// Unlike an opaque predicate it can be inspected, so the manager can answer it from an index.
+// Company tests see an empty company for personal contacts.
+class ContactQuery {
+public:
+    enum class Op : unsigned char {
+        Equals,
+        Prefix,
+        Contains,
+        IsBusiness,
+        And,
+        Or,
+        Not
+    };
+
+    static ContactQuery equals(ContactField field, std::string value);
+    static ContactQuery prefix(ContactField field, std::string value);
+    static ContactQuery contains(ContactField field, std::string value);
+    static ContactQuery isBusiness();
+
+    friend ContactQuery operator&&(const ContactQuery& a, const ContactQuery& b);
+    friend ContactQuery operator||(const ContactQuery& a, const ContactQuery& b);
+    friend ContactQuery operator!(const ContactQuery& a);
+
+    Op op() const { return m_node->op; }
+    ContactField field() const { return m_node->field; }      // Field tests only
+    const std::string& value() const { return m_node->value; } // Field tests only
+    const std::vector<ContactQuery>& children() const { return m_node->children; } // And / Or / Not
+
+    // Test a single contact (used on the few candidates an index returns)
+    bool matches(const Contact& contact) const;
+
+    // Test every row, bit r of the result is set when row r matches (one tight loop per field test)
+    std::vector<std::uint64_t> evaluate(const ContactColumns& columns) const;
+
+private:
+    struct Node {
+        Op op;
+        ContactField field;
+        std::string value;
+        std::vector<ContactQuery> children;
+    };
+
+    explicit ContactQuery(std::shared_ptr<const Node> node) : m_node(std::move(node)) {}
+    static ContactQuery combine(Op op, const ContactQuery& a, const ContactQuery& b);
+
+    std::shared_ptr<const Node> m_node; // Immutable, so copies share subtrees
+};
+
+// Index of the lowest set bit, word must not be 0
+inline std::size_t lowestSetBit(std::uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return index;
+#else
+    return static_cast<std::size_t>(__builtin_ctzll(word));
+#endif
+}
+
+// Call visit(row) for every row set in a result of ContactQuery::evaluate, in row order
+template<typename Visitor>
+void forEachRow(const std::vector<std::uint64_t>& bits, Visitor&& visit) {
+    for (std::size_t w = 0; w < bits.size(); ++w) {
+        for (std::uint64_t word = bits[w]; word != 0; word &= word - 1) {
+            visit(w * 64 + lowestSetBit(word));
+        }
+    }
+}
+
+} // namespace contact_management
+
+#endif // CONTACT_QUERY_H
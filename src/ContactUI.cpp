@@ -8,6 +8,8 @@ namespace contact_management {
 ContactUI::ContactUI() : m_isRunning(true) {}
 
 void ContactUI::run() {
+    offerAutoSaveRecovery();
+
     std::string choice;
     do {
         displayMenu();
@@ -56,6 +58,9 @@ void ContactUI::run() {
                     filterContacts();
                     break;
                 case 12:
+                    browseContacts();
+                    break;
+                case 13:
                     m_isRunning = false;
                     std::cout << "Exiting..." << std::endl;
                     break;
@@ -78,6 +83,25 @@ void ContactUI::run() {
     countThread.join();
 }
 
+void ContactUI::offerAutoSaveRecovery() {
+    if (!m_contactManager.hasAutoSave()) {
+        return;
+    }
+    std::string input;
+    std::cout << "Found contacts auto-saved by an earlier session. Restore them? (1 for yes, 0 for no): ";
+    std::getline(std::cin, input);
+    if (input != "1") {
+        return; // The next auto-save replaces them with this session's contacts
+    }
+    try {
+        m_contactManager.recoverFromAutoSave();
+        std::cout << "Restored " << m_contactManager.getContactCount() << " contacts." << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+    }
+    std::cout << std::endl;
+}
+
 void ContactUI::displayMenu() {
     std::cout << "Contact Management System" << std::endl;
     std::cout << "1. Add Contact" << std::endl;
@@ -91,7 +115,8 @@ void ContactUI::displayMenu() {
     std::cout << "9. Export Contacts to JSON" << std::endl;
     std::cout << "10. Import Contacts from JSON" << std::endl;
     std::cout << "11. Filter Contacts" << std::endl;
-    std::cout << "12. Exit" << std::endl;
+    std::cout << "12. Browse Contacts Alphabetically" << std::endl;
+    std::cout << "13. Exit" << std::endl;
     std::cout << "Enter your choice: ";
 }
 
@@ -112,9 +137,9 @@ void ContactUI::addContact() {
     if (isBusinessContact) {
         std::cout << "Enter company: ";
         std::getline(std::cin, company);
-        m_contactManager.addContact(std::make_shared<BusinessContact>(name, phone, email, company));
+        m_contactManager.addContact(std::make_shared<BusinessContact>(std::move(name), std::move(phone), std::move(email), std::move(company)));
     } else {
-        m_contactManager.addContact(std::make_shared<Contact>(name, phone, email));
+        m_contactManager.addContact(std::make_shared<Contact>(std::move(name), std::move(phone), std::move(email)));
     }
 
     std::cout << "Contact added successfully!" << std::endl;
@@ -148,7 +173,38 @@ void ContactUI::removeContact() {
 }
 
 void ContactUI::displayContacts() {
-    m_contactManager.displayAllContacts(); // Call the renamed function
+    std::string format;
+    std::cout << "Output format (1. Plain, 2. TSV, 3. CSV) [1]: ";
+    std::getline(std::cin, format);
+    if (format == "2") {
+        m_contactManager.displayAllContacts(OutputFormat::Tsv);
+    } else if (format == "3") {
+        m_contactManager.displayAllContacts(OutputFormat::Csv);
+    } else {
+        m_contactManager.displayAllContacts(); // Call the renamed function
+    }
+}
+
+void ContactUI::browseContacts() {
+    const size_t pageSize = 10;
+    size_t total = m_contactManager.getContactCount();
+    if (total == 0) {
+        std::cout << "No contacts to display." << std::endl;
+        return;
+    }
+    for (size_t offset = 0; offset < total; offset += pageSize) {
+        m_contactManager.displayPage(offset, pageSize); // Only this page is copied out of the sorted index
+        std::cout << "Contacts " << offset + 1 << "-" << std::min(offset + pageSize, total) << " of " << total << std::endl;
+        if (offset + pageSize >= total) {
+            break;
+        }
+        std::cout << "Press Enter for the next page or q to stop: ";
+        std::string input;
+        std::getline(std::cin, input);
+        if (input == "q") {
+            break;
+        }
+    }
 }
 
 void ContactUI::findContactsByName() {
@@ -205,42 +261,31 @@ void ContactUI::filterContacts() {
     std::string choice;
     std::getline(std::cin, choice);
 
-    std::function<bool(const Contact&)> filter;
-
     switch (std::stoi(choice)) {
         case 1: {
             std::cout << "Enter starting letters: ";
             std::string start;
             std::getline(std::cin, start);
-            filter = [start](const Contact& c) { 
-                return c.getName().substr(0, start.length()) == start;
-            };
-            break;
+            displayFilteredContacts(m_contactManager.findByNamePrefix(start), 10); // Served by the prefix index
+            return;
         }
         case 2:
-            filter = [](const Contact& c) { 
-                return dynamic_cast<const BusinessContact*>(&c) != nullptr;
-            };
-            break;
+            displayFilteredContacts(m_contactManager.findContacts(ContactQuery::isBusiness()), 10); // Scans the kind column
+            return;
         case 3: {
             std::cout << "Enter area code: ";
             std::string areaCode;
             std::getline(std::cin, areaCode);
-            filter = [areaCode](const Contact& c) { 
-                return c.getPhone().substr(0, areaCode.length()) == areaCode;
-            };
-            break;
+            displayFilteredContacts(m_contactManager.findByPhonePrefix(areaCode), 10); // Served by the prefix index
+            return;
         }
         default:
             std::cout << "Invalid choice. No filter applied.\n";
             return;
     }
-
-    auto filteredContacts = m_contactManager.filterContacts(filter);
-    displayFilteredContacts(filteredContacts,10);
 }
 
-void ContactUI::displayFilteredContacts(const std::vector<std::shared_ptr<Contact>>& contacts, size_t limit) {
+void ContactUI::displayFilteredContacts(const std::vector<std::shared_ptr<const Contact>>& contacts, size_t limit) {
     for (size_t i = 0; i < std::min(contacts.size(), limit); ++i) {
         contacts[i]->displayDetails();
         std::cout << std::endl;
@@ -251,7 +296,8 @@ void ContactUI::displayFilteredContacts(const std::vector<std::shared_ptr<Contac
 }
 
 void ContactUI::setFavoriteContact() {
-    std::vector<std::shared_ptr<Contact>> contacts = m_contactManager.getAllContacts();
+    std::vector<std::shared_ptr<const Contact>> contacts = m_contactManager.getAllContacts();
+    std::vector<ContactId> ids = m_contactManager.getContactIds(); // The numbers shown map to these, not to positions
     
     if (contacts.empty()) {
         std::cout << "No contacts available to set as favorite." << std::endl;
@@ -275,12 +321,17 @@ void ContactUI::setFavoriteContact() {
         std::cout << "Invalid choice. Please try again." << std::endl;
     }
 
-    m_contactManager.setFavoriteContact(choice - 1);  // Subtract 1 because array is 0-indexed
-    std::cout << "Favorite contact set to: " << contacts[choice - 1]->getName() << std::endl;
+    try {
+        m_contactManager.setFavoriteContactById(ids[choice - 1]);  // Subtract 1 because array is 0-indexed
+        std::cout << "Favorite contact set to: " << contacts[choice - 1]->getName() << std::endl;
+    }
+    catch (const std::out_of_range&) {
+        std::cerr << "Error: That contact was removed meanwhile." << std::endl;
+    }
 }
 
 void ContactUI::displayFavoriteContact() {
-    const Contact* favoriteContact = m_contactManager.getFavoriteContact();
+    auto favoriteContact = m_contactManager.getFavoriteContact();
     if (favoriteContact == nullptr) {
         std::cout << "No favorite contact set." << std::endl;
     } else {
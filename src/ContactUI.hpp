@@ -26,10 +26,12 @@ private:
         return filename + ".json";
     }
     void displayMenu();
+    void offerAutoSaveRecovery(); // On startup, restore what an earlier session auto-saved if the user wants it
     void addContact();
     void removeContact();
     void displayContacts();
-    void displayFilteredContacts(const std::vector<std::shared_ptr<Contact>>& contacts, size_t limit = std::numeric_limits<size_t>::max());
+    void browseContacts(); // Sorted by name, one page at a time
+    void displayFilteredContacts(const std::vector<std::shared_ptr<const Contact>>& contacts, size_t limit = std::numeric_limits<size_t>::max());
 
     void findContactsByName();
     void saveContactsToFile();
@@ -42,7 +44,7 @@ inline bool isValidChoice(const std::string& choice) const {
     if (choice.length() == 1) {
         return choice[0] >= '1' && choice[0] <= '9';
     } else if (choice.length() == 2) {
-        return choice == "10" || choice == "11" || choice == "12";
+        return choice == "10" || choice == "11" || choice == "12" || choice == "13";
     }
     return false;
 }
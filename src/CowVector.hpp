@@ -0,0 +1,172 @@
+// CowVector.hpp
+#ifndef COW_VECTOR_H
+#define COW_VECTOR_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+
+namespace contact_management { // Everything in a self-made namespace
+
+// Vector stored as a list of shared chunks. Copying it only copies the chunk pointers
+// (size / chunkCapacity of them), so taking an immutable snapshot is cheap; a chunk is cloned
+// the first time it is modified after a copy was taken (copy-on-write).
+// Copies must be taken while no other thread modifies the source (e.g. under a reader lock).
+//
+// Sharing is tracked with an epoch rather than use_count(): every copy bumps the source's epoch, and a
+// chunk is only written in place if it was created or cloned after the last copy, so no copy has ever
+// seen it. (use_count() == 1 races with a snapshot being destroyed on another thread.) The price is one
+// clone per written chunk after each copy, even if that copy is already gone.
+template<typename T>
+class CowVector {
+public:
+    static const std::size_t chunkCapacity = 1024;
+    using Chunk = std::vector<T>;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() : m_chunks(nullptr), m_chunk(0), m_offset(0) {}
+        const_iterator(const std::vector<std::shared_ptr<Chunk>>* chunks, std::size_t chunk)
+            : m_chunks(chunks), m_chunk(chunk), m_offset(0) {}
+
+        reference operator*() const { return (*(*m_chunks)[m_chunk])[m_offset]; }
+        pointer operator->() const { return &**this; }
+
+        const_iterator& operator++() {
+            if (++m_offset == (*m_chunks)[m_chunk]->size()) {
+                ++m_chunk;
+                m_offset = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const { return m_chunk == other.m_chunk && m_offset == other.m_offset; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        const std::vector<std::shared_ptr<Chunk>>* m_chunks;
+        std::size_t m_chunk;  // Chunks are never empty, so (chunk count, 0) is end()
+        std::size_t m_offset;
+    };
+
+    CowVector() : m_size(0), m_epoch(1) {}
+    CowVector(std::vector<T> values) : CowVector() { // Implicit, so loaders can assign a plain vector
+        for (auto& value : values) {
+            push_back(std::move(value));
+        }
+    }
+
+    // The copy shares every chunk with other, so both sides clone a chunk before writing to it
+    CowVector(const CowVector& other)
+        : m_chunks(other.m_chunks), m_chunkEpochs(other.m_chunks.size(), 0), m_size(other.m_size), m_epoch(1) {
+        other.m_epoch.fetch_add(1, std::memory_order_relaxed); // Readers may copy concurrently, hence atomic
+    }
+    CowVector(CowVector&& other) noexcept
+        : m_chunks(std::move(other.m_chunks)), m_chunkEpochs(std::move(other.m_chunkEpochs)), m_size(other.m_size),
+          m_epoch(other.m_epoch.load(std::memory_order_relaxed)) {
+        other.clear();
+    }
+
+    CowVector& operator=(const CowVector& other) {
+        if (this != &other) {
+            m_chunks = other.m_chunks;
+            m_chunkEpochs.assign(m_chunks.size(), 0); // No epoch is 0, so none of them is writable in place
+            m_size = other.m_size;
+            other.m_epoch.fetch_add(1, std::memory_order_relaxed);
+        }
+        return *this;
+    }
+    CowVector& operator=(CowVector&& other) noexcept {
+        if (this != &other) {
+            m_chunks = std::move(other.m_chunks);
+            m_chunkEpochs = std::move(other.m_chunkEpochs);
+            m_size = other.m_size;
+            m_epoch.store(other.m_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            other.clear();
+        }
+        return *this;
+    }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const T& operator[](std::size_t index) const {
+        return (*m_chunks[index / chunkCapacity])[index % chunkCapacity]; // Every chunk but the last is full
+    }
+
+    const_iterator begin() const { return const_iterator(&m_chunks, 0); }
+    const_iterator end() const { return const_iterator(&m_chunks, m_chunks.size()); }
+
+    void push_back(T value) {
+        if (m_chunks.empty() || m_chunks.back()->size() >= chunkCapacity) {
+            auto chunk = std::make_shared<Chunk>();
+            chunk->reserve(chunkCapacity);
+            m_chunks.push_back(std::move(chunk));
+            m_chunkEpochs.push_back(m_epoch.load(std::memory_order_relaxed)); // Nobody else has seen it yet
+        }
+        writableChunk(m_chunks.size() - 1).push_back(std::move(value));
+        ++m_size;
+    }
+
+    // O(1): the last element moves into index, nothing shifts (order is not preserved)
+    void swapRemove(std::size_t index) {
+        if (index + 1 != m_size) {
+            T last = std::move(writableChunk(m_chunks.size() - 1).back());
+            writableChunk(index / chunkCapacity)[index % chunkCapacity] = std::move(last);
+        }
+        pop_back();
+    }
+
+    void pop_back() {
+        Chunk& chunk = writableChunk(m_chunks.size() - 1);
+        chunk.pop_back();
+        if (chunk.empty()) {
+            m_chunks.pop_back();
+            m_chunkEpochs.pop_back();
+        }
+        --m_size;
+    }
+
+    void clear() {
+        m_chunks.clear();
+        m_chunkEpochs.clear();
+        m_size = 0;
+    }
+
+private:
+    Chunk& writableChunk(std::size_t chunk) {
+        // Copies are only taken while nobody modifies this vector, so the epoch can't change during a write
+        std::uint64_t epoch = m_epoch.load(std::memory_order_relaxed);
+        if (m_chunkEpochs[chunk] != epoch) {
+            auto clone = std::make_shared<Chunk>();
+            clone->reserve(chunkCapacity);
+            clone->assign(m_chunks[chunk]->begin(), m_chunks[chunk]->end()); // A copy may still read the old one
+            m_chunks[chunk] = std::move(clone);
+            m_chunkEpochs[chunk] = epoch;
+        }
+        return *m_chunks[chunk];
+    }
+
+    std::vector<std::shared_ptr<Chunk>> m_chunks;
+    std::vector<std::uint64_t> m_chunkEpochs; // Epoch each chunk was created or cloned in, parallel to m_chunks
+    std::size_t m_size;
+    mutable std::atomic<std::uint64_t> m_epoch; // Bumped by every copy taken from this vector, starts at 1
+};
+
+} // namespace contact_management
+
+#endif // COW_VECTOR_H
@@ -0,0 +1,136 @@
+// FileUtils.cpp
+#include "FileUtils.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace contact_management { // Everything in a self-made namespace
+
+namespace {
+
+std::atomic<unsigned long> tempFileCounter{0};
+
+// Create an empty file with a name no other writer uses: <filename>.tmp.<process id>.<counter>.
+// Created exclusively, so even a reused process id can't make two writers share it.
+std::string createTempFile(const std::string& filename) {
+    for (int attempt = 0; attempt < 100; ++attempt) {
+#if defined(_WIN32)
+        std::string name = filename + ".tmp." + std::to_string(GetCurrentProcessId()) + "." + std::to_string(tempFileCounter++);
+        HANDLE file = CreateFileA(name.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+            return name;
+        }
+        if (GetLastError() != ERROR_FILE_EXISTS) {
+            break;
+        }
+#else
+        std::string name = filename + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(tempFileCounter++);
+        int fd = ::open(name.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+        if (fd >= 0) {
+            ::close(fd);
+            return name;
+        }
+        if (errno != EEXIST) {
+            break;
+        }
+#endif
+    }
+    throw std::runtime_error("Unable to create a temporary file for " + filename);
+}
+
+#if !defined(_WIN32)
+// Directory entries (a rename) are only durable once the directory itself is synced
+void syncDirectoryOf(const std::string& filename) {
+    std::string::size_type slash = filename.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : filename.substr(0, slash);
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open directory " + directory);
+    }
+    int result = ::fsync(fd);
+    int error = errno;
+    ::close(fd);
+    if (result != 0 && error != EINVAL && error != ENOTSUP) { // Some file systems can't sync a directory
+        throw std::runtime_error("Unable to sync directory " + directory);
+    }
+}
+#endif
+
+} // namespace
+
+void syncFile(const std::string& filename) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Unable to open " + filename + " to sync it");
+    }
+    BOOL flushed = FlushFileBuffers(file);
+    CloseHandle(file);
+    if (!flushed) {
+        throw std::runtime_error("Unable to sync " + filename);
+    }
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open " + filename + " to sync it");
+    }
+    int result = ::fsync(fd);
+    ::close(fd);
+    if (result != 0) {
+        throw std::runtime_error("Unable to sync " + filename); // The data may not be on disk, don't report success
+    }
+#endif
+}
+
+void replaceFile(const std::string& source, const std::string& target) {
+#if defined(_WIN32)
+    // std::rename refuses to overwrite on Windows; write-through makes the move durable before returning
+    if (!MoveFileExA(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        throw std::runtime_error("Unable to replace " + target);
+    }
+#else
+    if (std::rename(source.c_str(), target.c_str()) != 0) {
+        throw std::runtime_error("Unable to replace " + target);
+    }
+    syncDirectoryOf(target);
+#endif
+}
+
+void writeFileAtomically(const std::string& filename, std::ios::openmode mode, const std::function<void(std::ostream&)>& write,
+                         const std::function<void(const std::string&)>& beforeReplace) {
+    const std::string tempFile = createTempFile(filename);
+    try {
+        {
+            std::ofstream file(tempFile, mode | std::ios::out | std::ios::trunc);
+            if (!file) {
+                throw std::runtime_error("Unable to open file for writing");
+            }
+            write(file);
+            file.close();
+            if (!file) {
+                throw std::runtime_error("Unable to write file");
+            }
+        }
+        syncFile(tempFile); // The data must be durable before the rename makes it the real file
+        if (beforeReplace) {
+            beforeReplace(tempFile);
+        }
+        replaceFile(tempFile, filename);
+    } catch (...) {
+        std::remove(tempFile.c_str()); // Already gone if only the directory sync failed
+        throw;
+    }
+}
+
+} // namespace contact_management
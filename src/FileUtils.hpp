@@ -0,0 +1,28 @@
+// FileUtils.hpp
+#ifndef FILE_UTILS_H
+#define FILE_UTILS_H
+
+#include <string>
+#include <ostream>
+#include <ios>
+#include <functional>
+
+namespace contact_management { // Everything in a self-made namespace
+
+// Flush a written file's data to stable storage, throws std::runtime_error if that fails
+void syncFile(const std::string& filename);
+
+// Atomically replace target with source (rename over an existing file), then sync target's directory so the
+// rename itself survives a crash. Throws std::runtime_error on failure.
+void replaceFile(const std::string& source, const std::string& target);
+
+// Write filename through a temp file next to it, named uniquely so concurrent saves of the same file can't
+// collide: write fills the opened stream, then the temp file is synced, beforeReplace (if given) gets its
+// name, and it is renamed over filename. A crash leaves the old file or the new one, never a torn one.
+// Throws std::runtime_error if the file can't be written or synced, the temp file is removed on any failure.
+void writeFileAtomically(const std::string& filename, std::ios::openmode mode, const std::function<void(std::ostream&)>& write,
+                         const std::function<void(const std::string&)>& beforeReplace = nullptr);
+
+} // namespace contact_management
+
+#endif // FILE_UTILS_H
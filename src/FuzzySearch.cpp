@@ -0,0 +1,146 @@
+// FuzzySearch.cpp
+#include "FuzzySearch.hpp"
+#include <algorithm>
+
+namespace contact_management { // Everything in a self-made namespace
+
+namespace {
+
+unsigned char foldAscii(unsigned char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c | 0x20) : c;
+}
+
+// Append the trigrams of "\0\0" + text + "\0\0" (text.size() + 2 of them), then sort and drop repeats
+void trigramsOf(std::string_view text, std::vector<std::uint32_t>& grams) {
+    std::uint32_t window = 0; // Starts out as the two leading pad bytes
+    for (std::size_t i = 0; i < text.size() + 2; ++i) {
+        unsigned char c = i < text.size() ? foldAscii(static_cast<unsigned char>(text[i])) : 0;
+        window = ((window << 8) | c) & 0xFFFFFF;
+        grams.push_back(window);
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+}
+
+} // namespace
+
+void TrigramIndex::clear() {
+    std::unordered_map<std::uint32_t, std::vector<SlotId>>().swap(m_postings);
+    m_removedCount = 0;
+    m_built = false;
+}
+
+void TrigramIndex::add(std::string_view name, std::string_view email, SlotId id) {
+    std::vector<std::uint32_t> grams;
+    grams.reserve(name.size() + email.size() + 4);
+    trigramsOf(name, grams);
+    trigramsOf(email, grams); // Sorted and deduplicated again across both fields
+    for (std::uint32_t gram : grams) {
+        m_postings[gram].push_back(id);
+    }
+}
+
+bool TrigramIndex::candidates(std::string_view query, unsigned maxDistance, std::vector<SlotId>& ids) const {
+    std::vector<std::uint32_t> grams;
+    trigramsOf(query, grams);
+    std::size_t needed = 3 * static_cast<std::size_t>(maxDistance) + 1;
+    if (grams.size() < needed) {
+        return false;
+    }
+    static const std::vector<SlotId> none;
+    std::vector<const std::vector<SlotId>*> lists;
+    lists.reserve(grams.size());
+    for (std::uint32_t gram : grams) {
+        auto it = m_postings.find(gram);
+        lists.push_back(it == m_postings.end() ? &none : &it->second);
+    }
+    std::partial_sort(lists.begin(), lists.begin() + needed, lists.end(),
+                      [](const std::vector<SlotId>* a, const std::vector<SlotId>* b) { return a->size() < b->size(); });
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < needed; ++i) {
+        total += lists[i]->size();
+    }
+    ids.reserve(ids.size() + total);
+    for (std::size_t i = 0; i < needed; ++i) {
+        ids.insert(ids.end(), lists[i]->begin(), lists[i]->end());
+    }
+    return true;
+}
+
+EditDistance::EditDistance(std::string_view pattern, unsigned maxDistance)
+    : m_pattern(pattern), m_maxDistance(maxDistance), m_peq() {
+    if (pattern.size() <= 64) {
+        for (std::size_t i = 0; i < pattern.size(); ++i) {
+            unsigned char c = foldAscii(static_cast<unsigned char>(pattern[i]));
+            m_peq[c] |= std::uint64_t(1) << i;
+            if (c >= 'a' && c <= 'z') {
+                m_peq[c & ~0x20] |= std::uint64_t(1) << i; // Upper case text bytes look up their own entry
+            }
+        }
+    }
+}
+
+unsigned EditDistance::operator()(std::string_view text) const {
+    std::size_t m = m_pattern.size();
+    std::size_t n = text.size();
+    std::size_t lengthGap = m > n ? m - n : n - m;
+    if (lengthGap > m_maxDistance) {
+        return m_maxDistance + 1; // Needs at least that many insertions or deletions
+    }
+    if (m == 0 || m > 64) {
+        return m == 0 ? static_cast<unsigned>(n) : dynamicProgram(text);
+    }
+
+    // Myers / Hyyro: Pv and Mv hold the +1 / -1 vertical differences of the current DP column,
+    // score tracks the bottom cell, which ends as the distance
+    const std::uint64_t highBit = std::uint64_t(1) << (m - 1);
+    std::uint64_t pv = ~std::uint64_t(0);
+    std::uint64_t mv = 0;
+    std::size_t score = m;
+    for (std::size_t j = 0; j < n; ++j) {
+        std::uint64_t eq = m_peq[static_cast<unsigned char>(text[j])];
+        std::uint64_t xv = eq | mv;
+        std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        std::uint64_t ph = mv | ~(xh | pv);
+        std::uint64_t mh = pv & xh;
+        if (ph & highBit) {
+            ++score;
+        } else if (mh & highBit) {
+            --score;
+        }
+        ph = (ph << 1) | 1; // The top row grows by one per text byte: global, not substring, distance
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+        // The score falls by at most one per remaining byte
+        if (score > m_maxDistance + (n - j - 1)) {
+            return m_maxDistance + 1;
+        }
+    }
+    return static_cast<unsigned>(std::min<std::size_t>(score, m_maxDistance + 1));
+}
+
+unsigned EditDistance::dynamicProgram(std::string_view text) const {
+    std::vector<std::size_t> row(text.size() + 1);
+    for (std::size_t j = 0; j <= text.size(); ++j) {
+        row[j] = j;
+    }
+    for (std::size_t i = 1; i <= m_pattern.size(); ++i) {
+        std::size_t diagonal = row[0];
+        row[0] = i;
+        std::size_t rowMin = row[0];
+        unsigned char p = foldAscii(static_cast<unsigned char>(m_pattern[i - 1]));
+        for (std::size_t j = 1; j <= text.size(); ++j) {
+            std::size_t substitution = diagonal + (p != foldAscii(static_cast<unsigned char>(text[j - 1])));
+            diagonal = row[j];
+            row[j] = std::min({substitution, row[j] + 1, row[j - 1] + 1});
+            rowMin = std::min(rowMin, row[j]);
+        }
+        if (rowMin > m_maxDistance) {
+            return m_maxDistance + 1; // Distances never shrink going down
+        }
+    }
+    return static_cast<unsigned>(std::min<std::size_t>(row[text.size()], m_maxDistance + 1));
+}
+
+} // namespace contact_management
@@ -0,0 +1,58 @@
+// FuzzySearch.hpp
+#ifndef FUZZY_SEARCH_H
+#define FUZZY_SEARCH_H
+
+#include "SlotMap.hpp"
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace contact_management { // Everything in a self-made namespace
+
+// Inverted index from trigrams (3-byte substrings, ASCII case folded, padded at both ends) to the ids
+// of the contacts whose name or email contains them.
+// Removal is lazy: removed ids stay in the lists and the caller skips the ones that no longer resolve.
+class TrigramIndex {
+public:
+    bool built() const { return m_built; }
+    void markBuilt() { m_built = true; }
+    void clear(); // Frees the lists, built() is false again
+
+    void add(std::string_view name, std::string_view email, SlotId id);
+    void noteRemoved() { ++m_removedCount; }
+    std::size_t removedCount() const { return m_removedCount; }
+
+    // Ids that may be within maxDistance edits of query, taken from the shortest lists of query's
+    // trigrams (a superset that can repeat ids and include removed ones). Every edit breaks at most
+    // three trigrams, so any 3 * maxDistance + 1 of them include one the match still has.
+    // False when query has too few trigrams to rule anything out.
+    bool candidates(std::string_view query, unsigned maxDistance, std::vector<SlotId>& ids) const;
+
+private:
+    std::unordered_map<std::uint32_t, std::vector<SlotId>> m_postings;
+    std::size_t m_removedCount = 0;
+    bool m_built = false;
+};
+
+// Levenshtein distance from a fixed pattern, ASCII case folded. Patterns up to 64 bytes use Myers'
+// bit-parallel algorithm (one machine word per text byte), longer ones the textbook dynamic program.
+class EditDistance {
+public:
+    EditDistance(std::string_view pattern, unsigned maxDistance); // pattern must outlive it
+
+    // Distance to text, or maxDistance + 1 as soon as it's known to exceed maxDistance
+    unsigned operator()(std::string_view text) const;
+
+private:
+    unsigned dynamicProgram(std::string_view text) const;
+
+    std::string_view m_pattern;
+    unsigned m_maxDistance;
+    std::uint64_t m_peq[256]; // Bit i of m_peq[c] is set when pattern[i] folds to c
+};
+
+} // namespace contact_management
+
+#endif // FUZZY_SEARCH_H
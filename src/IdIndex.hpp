@@ -0,0 +1,165 @@
+// IdIndex.hpp
+#ifndef ID_INDEX_H
+#define ID_INDEX_H
+
+#include "SlotMap.hpp"
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace contact_management { // Everything in a self-made namespace
+
+// Hash index from a key to the SlotMap ids filed under it, in the order they were added. The ids of one
+// key form a list linked through a table indexed by slot, so removing an id is O(1) however many ids
+// share its key (a multimap has to walk the key's whole range to find it). Each id is filed at most once.
+// With std::string_view keys the stored key views the oldest id's string, so removals have to say
+// where the next id's copy is.
+template<typename Key>
+class IdIndex {
+    struct Links {
+        SlotId previous; // The key's last id for its first one, 0 while the slot isn't filed
+        SlotId next;     // 0 for the last one
+    };
+
+public:
+    using key_type = Key;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = SlotId;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const SlotId*;
+        using reference = const SlotId&;
+
+        const_iterator() : m_links(nullptr), m_id(0) {}
+        const_iterator(const std::vector<Links>* links, SlotId id) : m_links(links), m_id(id) {}
+
+        reference operator*() const { return m_id; }
+        const_iterator& operator++() {
+            m_id = (*m_links)[slotOf(m_id)].next;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const { return m_id == other.m_id; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        const std::vector<Links>* m_links;
+        SlotId m_id; // 0 is end()
+    };
+
+    std::size_t size() const { return m_size; }
+
+    // Room for count ids in all. Only the new ones can bring new keys, and the link table grows
+    // geometrically, so reserving a little more before every batch doesn't copy it each time.
+    void reserve(std::size_t count) {
+        if (count > m_size) {
+            m_first.reserve(m_first.size() + (count - m_size));
+        }
+        if (count > m_links.capacity()) {
+            m_links.reserve(std::max(count, 2 * m_links.capacity()));
+        }
+    }
+
+    void clear() {
+        m_first.clear();
+        m_links.clear();
+        m_size = 0;
+    }
+
+    // The ids filed under key, oldest first
+    std::pair<const_iterator, const_iterator> equal_range(const Key& key) const {
+        return std::make_pair(const_iterator(&m_links, front(key)), const_iterator(&m_links, 0));
+    }
+
+    // The oldest id filed under key, 0 if there is none
+    SlotId front(const Key& key) const {
+        auto it = m_first.find(key);
+        return it == m_first.end() ? 0 : it->second;
+    }
+
+    void add(Key key, SlotId id) {
+        std::size_t slot = slotOf(id);
+        if (slot >= m_links.size()) {
+            m_links.resize(slot + 1, Links{0, 0});
+        }
+        auto inserted = m_first.emplace(std::move(key), id);
+        if (inserted.second) {
+            m_links[slot] = Links{id, 0};
+        } else { // Goes after the key's last id
+            Links& first = m_links[slotOf(inserted.first->second)];
+            m_links[slotOf(first.previous)].next = id;
+            m_links[slot] = Links{first.previous, 0};
+            first.previous = id;
+        }
+        ++m_size;
+    }
+
+    // O(1); does nothing if id isn't filed under key
+    void remove(const Key& key, SlotId id) {
+        static_assert(!std::is_same<Key, std::string_view>::value, "Views need keyOf, see below");
+        removeFiled(key, id, nullptr);
+    }
+    // keyOf(otherId) returns the key as filed by otherId (the same characters, its own copy)
+    template<typename KeyOf>
+    void remove(const Key& key, SlotId id, KeyOf&& keyOf) {
+        removeFiled(key, id, std::forward<KeyOf>(keyOf));
+    }
+
+private:
+    template<typename KeyOf>
+    void removeFiled(const Key& key, SlotId id, KeyOf&& keyOf) {
+        std::size_t slot = slotOf(id);
+        auto it = slot < m_links.size() && m_links[slot].previous != 0 ? m_first.find(key) : m_first.end();
+        if (it == m_first.end()) {
+            return;
+        }
+        Links self = m_links[slot];
+        if (it->second == id) {
+            if (self.next == 0) {
+                m_first.erase(it);
+            } else {
+                m_links[slotOf(self.next)].previous = self.previous;
+                if constexpr (std::is_same<std::decay_t<KeyOf>, std::nullptr_t>::value) {
+                    it->second = self.next;
+                } else { // The stored key may view id's string, move it to the next one's
+                    auto node = m_first.extract(it);
+                    node.key() = keyOf(self.next);
+                    node.mapped() = self.next;
+                    m_first.insert(std::move(node));
+                }
+            }
+        } else {
+            if (m_links[slotOf(self.previous)].next != id) {
+                return; // Filed under another key
+            }
+            m_links[slotOf(self.previous)].next = self.next;
+            // The next one, or the first one if id was the last
+            m_links[slotOf(self.next != 0 ? self.next : it->second)].previous = self.previous;
+        }
+        m_links[slot] = Links{0, 0};
+        --m_size;
+    }
+
+    static std::size_t slotOf(SlotId id) { return static_cast<std::uint32_t>(id); }
+
+    std::unordered_map<Key, SlotId> m_first; // Key -> its oldest id
+    std::vector<Links> m_links;               // Indexed by slot
+    std::size_t m_size = 0;
+};
+
+} // namespace contact_management
+
+#endif // ID_INDEX_H
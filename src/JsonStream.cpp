@@ -0,0 +1,242 @@
+// JsonStream.cpp
+#include "JsonStream.hpp"
+#include "../external/json.hpp"
+#include <stdexcept>
+#include <cstdio>
+
+namespace contact_management { // Everything in a self-made namespace
+
+using json = nlohmann::json;
+
+JsonContactWriter::JsonContactWriter(std::ostream& out, JsonLayout layout)
+    : m_out(out), m_layout(layout), m_isFirst(true) {
+    m_buffer.reserve(bufferSize);
+}
+
+void JsonContactWriter::begin() {
+    if (m_layout == JsonLayout::Indented) {
+        m_buffer += "{\n    \"contacts\": [";
+    } else if (m_layout == JsonLayout::Compact) {
+        m_buffer += "{\"contacts\":[";
+    }
+}
+
+void JsonContactWriter::write(std::string_view name, std::string_view phone, std::string_view email, std::string_view company) {
+    bool indented = m_layout == JsonLayout::Indented;
+    const char* separator = indented ? ",\n            " : ",";
+    if (!m_isFirst && m_layout != JsonLayout::Lines) {
+        m_buffer += ',';
+    }
+    m_buffer += indented ? "\n        {\n            \"company\": " : "{\"company\":";
+    writeString(company);
+    m_buffer += separator;
+    m_buffer += indented ? "\"email\": " : "\"email\":";
+    writeString(email);
+    m_buffer += separator;
+    m_buffer += indented ? "\"name\": " : "\"name\":";
+    writeString(name);
+    m_buffer += separator;
+    m_buffer += indented ? "\"phone\": " : "\"phone\":";
+    writeString(phone);
+    m_buffer += indented ? "\n        }" : "}";
+    if (m_layout == JsonLayout::Lines) {
+        m_buffer += '\n';
+    }
+    m_isFirst = false;
+
+    if (m_buffer.size() >= bufferSize) {
+        flushBuffer(); // Only whole lines are written, so an interrupted Lines export leaves complete records
+    }
+}
+
+void JsonContactWriter::end() {
+    if (m_layout == JsonLayout::Indented) {
+        m_buffer += m_isFirst ? "]\n}\n" : "\n    ]\n}\n";
+    } else if (m_layout == JsonLayout::Compact) {
+        m_buffer += "]}\n";
+    }
+    flushBuffer();
+    m_out.flush();
+    if (!m_out) {
+        throw std::runtime_error("Unable to write file");
+    }
+}
+
+void JsonContactWriter::writeString(std::string_view value) {
+    m_buffer += '"';
+    std::size_t start = 0;
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(value[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue; // Copied below in one run
+        }
+        m_buffer.append(value.data() + start, i - start);
+        start = i + 1;
+        switch (c) {
+            case '"': m_buffer += "\\\""; break;
+            case '\\': m_buffer += "\\\\"; break;
+            case '\b': m_buffer += "\\b"; break;
+            case '\f': m_buffer += "\\f"; break;
+            case '\n': m_buffer += "\\n"; break;
+            case '\r': m_buffer += "\\r"; break;
+            case '\t': m_buffer += "\\t"; break;
+            default: {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                m_buffer += escaped;
+            }
+        }
+    }
+    m_buffer.append(value.data() + start, value.size() - start);
+    m_buffer += '"';
+}
+
+void JsonContactWriter::flushBuffer() {
+    m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_buffer.clear();
+}
+
+namespace {
+
+// Tracks where the parser is in the document and collects the four fields of the current contact
+class ContactSaxHandler : public nlohmann::json_sax<json> {
+public:
+    explicit ContactSaxHandler(const JsonContactCallback& onContact)
+        : m_onContact(onContact), m_depth(0), m_contactsDepth(0), m_nextIsContacts(false), m_field(-1) {}
+
+    bool null() override { return m_depth == 0 || scalar(); } // An empty export used to be written as null
+    bool boolean(bool) override { return scalar(); }
+    bool number_integer(number_integer_t) override { return scalar(); }
+    bool number_unsigned(number_unsigned_t) override { return scalar(); }
+    bool number_float(number_float_t, const string_t&) override { return scalar(); }
+    bool binary(binary_t&) override { return scalar(); }
+
+    bool string(string_t& value) override {
+        if (inContact()) {
+            if (m_field >= 0) {
+                m_fields[m_field].swap(value); // Reuse the parser's buffer instead of copying
+                m_hasField[m_field] = true;
+            }
+            m_field = -1;
+            return true;
+        }
+        return scalar();
+    }
+
+    bool key(string_t& value) override {
+        if (m_depth == 1) {
+            m_nextIsContacts = value == "contacts";
+        } else if (inContact()) {
+            m_field = fieldIndex(value);
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        if (m_depth == 0) {
+            ++m_depth;
+            return true;
+        }
+        if (inContacts()) {
+            for (bool& hasField : m_hasField) {
+                hasField = false;
+            }
+            m_field = -1;
+        } else {
+            checkContainerValue();
+        }
+        ++m_depth;
+        return true;
+    }
+
+    bool end_object() override {
+        --m_depth;
+        if (inContacts()) {
+            for (bool hasField : m_hasField) {
+                if (!hasField) {
+                    throw std::runtime_error("Contact in JSON file is missing a field");
+                }
+            }
+            m_onContact(m_fields[0], m_fields[1], m_fields[2], m_fields[3]);
+        }
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        if (m_depth == 0) {
+            throw std::runtime_error("JSON file is not a contacts document");
+        }
+        if (m_depth == 1 && m_nextIsContacts) {
+            m_nextIsContacts = false;
+            ++m_depth;
+            m_contactsDepth = m_depth;
+            return true;
+        }
+        checkContainerValue();
+        ++m_depth;
+        return true;
+    }
+
+    bool end_array() override {
+        if (m_depth == m_contactsDepth) {
+            m_contactsDepth = 0;
+        }
+        --m_depth;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+        throw std::runtime_error(ex.what());
+    }
+
+private:
+    bool inContacts() const { return m_contactsDepth != 0 && m_depth == m_contactsDepth; }
+    bool inContact() const { return m_contactsDepth != 0 && m_depth == m_contactsDepth + 1; }
+
+    static int fieldIndex(const string_t& name) {
+        if (name == "name") return 0;
+        if (name == "phone") return 1;
+        if (name == "email") return 2;
+        if (name == "company") return 3;
+        return -1; // Unknown keys are skipped
+    }
+
+    // A non-string value: fine anywhere except as a contact field or a contacts element
+    bool scalar() {
+        if (m_depth == 0 || inContacts() || (inContact() && m_field >= 0)) {
+            throw std::runtime_error("Invalid contact in JSON file");
+        }
+        if (m_depth == 1) {
+            m_nextIsContacts = false;
+        }
+        m_field = -1;
+        return true;
+    }
+
+    void checkContainerValue() {
+        if (inContacts() || (inContact() && m_field >= 0)) {
+            throw std::runtime_error("Invalid contact in JSON file");
+        }
+        if (m_depth == 1 && m_nextIsContacts) {
+            throw std::runtime_error("JSON contacts value is not an array");
+        }
+        m_field = -1;
+    }
+
+    const JsonContactCallback& m_onContact;
+    std::size_t m_depth;         // Open objects and arrays
+    std::size_t m_contactsDepth; // Depth inside the contacts array, 0 when not in it
+    bool m_nextIsContacts;       // The last root key was "contacts"
+    int m_field;                 // Field the next value belongs to, -1 for none
+    std::string m_fields[4];     // name, phone, email, company
+    bool m_hasField[4] = {};
+};
+
+} // namespace
+
+void readJsonContacts(std::string_view data, const JsonContactCallback& onContact) {
+    ContactSaxHandler handler(onContact);
+    json::sax_parse(data.begin(), data.end(), &handler);
+}
+
+} // namespace contact_management
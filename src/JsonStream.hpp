@@ -0,0 +1,51 @@
+// JsonStream.hpp
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <functional>
+#include <cstddef>
+
+namespace contact_management { // Everything in a self-made namespace
+
+enum class JsonLayout {
+    Indented, // {"contacts": [...]} with a 4-space indent
+    Compact,  // Same document without whitespace
+    Lines     // JSON Lines: one compact contact object per line, no enclosing document
+};
+
+// Writes contacts one at a time, no DOM is built.
+// Output matches nlohmann's dump: keys in sorted order, 4-space indent (or none when compact).
+class JsonContactWriter {
+public:
+    JsonContactWriter(std::ostream& out, JsonLayout layout);
+
+    void begin();
+    void write(std::string_view name, std::string_view phone, std::string_view email, std::string_view company);
+    void end(); // Closes the document and flushes, throws std::runtime_error if the stream failed
+
+private:
+    void writeString(std::string_view value);
+    void flushBuffer();
+
+    std::ostream& m_out;
+    JsonLayout m_layout;
+    bool m_isFirst;
+    std::string m_buffer; // Filled up to bufferSize, then handed to the stream in one write
+
+    static const std::size_t bufferSize = 64 * 1024;
+};
+
+// Called once per contact while parsing, the views are only valid during the call
+using JsonContactCallback = std::function<void(std::string_view name, std::string_view phone,
+                                               std::string_view email, std::string_view company)>;
+
+// SAX-parse a {"contacts": [...]} document. Other keys are ignored, a contact missing one of
+// name/phone/email/company or holding a non-string value throws std::runtime_error.
+void readJsonContacts(std::string_view data, const JsonContactCallback& onContact);
+
+} // namespace contact_management
+
+#endif // JSON_STREAM_H
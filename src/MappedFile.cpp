@@ -0,0 +1,61 @@
+// MappedFile.cpp
+#include "MappedFile.hpp"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CONTACT_MANAGEMENT_HAS_MMAP 1
+#endif
+
+namespace contact_management { // Everything in a self-made namespace
+
+MappedFile::MappedFile(const std::string& filename) : m_data(nullptr), m_size(0), m_isMapped(false) {
+#ifdef CONTACT_MANAGEMENT_HAS_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open file for reading");
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Unable to open file for reading");
+    }
+    m_size = static_cast<std::size_t>(info.st_size);
+    if (m_size > 0) { // mmap rejects zero-length mappings, an empty file simply has no data
+        void* mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Unable to map file for reading");
+        }
+        ::madvise(mapping, m_size, MADV_SEQUENTIAL); // Loaders read front to back, let the kernel read ahead
+        m_data = static_cast<const char*>(mapping);
+        m_isMapped = true;
+    }
+    ::close(fd); // The mapping keeps its own reference to the file
+#else
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Unable to open file for reading");
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    m_fallback = contents.str();
+    m_data = m_fallback.data();
+    m_size = m_fallback.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef CONTACT_MANAGEMENT_HAS_MMAP
+    if (m_isMapped) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+#endif
+}
+
+} // namespace contact_management
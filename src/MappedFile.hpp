@@ -0,0 +1,33 @@
+// MappedFile.hpp
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+namespace contact_management { // Everything in a self-made namespace
+
+// Read-only view of a whole file. Uses mmap on POSIX systems, elsewhere the file is read into memory.
+class MappedFile {
+public:
+    // Throws std::runtime_error if the file can't be opened or mapped
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view data() const { return std::string_view(m_data, m_size); }
+    std::size_t size() const { return m_size; }
+
+private:
+    const char* m_data;
+    std::size_t m_size;
+    bool m_isMapped;        // True when m_data must be released with munmap
+    std::string m_fallback; // Owns the bytes when mmap isn't available
+};
+
+} // namespace contact_management
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,99 @@
+// OutputBuffer.cpp
+#include "OutputBuffer.hpp"
+
+namespace contact_management { // Everything in a self-made namespace
+
+namespace {
+
+// Bit 0: needs escaping in TSV, bit 1: forces quoting in CSV
+struct SpecialBytes {
+    unsigned char flags[256] = {};
+    SpecialBytes() {
+        flags[static_cast<unsigned char>('\t')] = 1;
+        flags[static_cast<unsigned char>('\\')] = 1;
+        flags[static_cast<unsigned char>('\n')] = 3;
+        flags[static_cast<unsigned char>('\r')] = 3;
+        flags[static_cast<unsigned char>(',')] = 2;
+        flags[static_cast<unsigned char>('"')] = 2;
+    }
+};
+const SpecialBytes specialBytes;
+
+// Position of the first byte of field at or after start with the given flag, or field.size()
+std::size_t findSpecial(std::string_view field, std::size_t start, unsigned char flag) {
+    while (start < field.size() && !(specialBytes.flags[static_cast<unsigned char>(field[start])] & flag)) {
+        ++start;
+    }
+    return start;
+}
+
+} // namespace
+
+OutputBuffer::OutputBuffer(std::ostream& out, std::size_t capacity)
+    : m_out(out), m_buffer(new char[capacity]), m_next(m_buffer.get()), m_end(m_buffer.get() + capacity) {}
+
+OutputBuffer::~OutputBuffer() {
+    flush(); // Stream errors set its state bits, like the std::cout calls this replaces
+}
+
+void OutputBuffer::flush() {
+    write();
+    m_out.flush();
+}
+
+void OutputBuffer::write() {
+    if (m_next != m_buffer.get()) {
+        m_out.write(m_buffer.get(), m_next - m_buffer.get());
+        m_next = m_buffer.get();
+    }
+}
+
+void OutputBuffer::appendSlow(std::string_view text) {
+    write();
+    if (text.size() >= static_cast<std::size_t>(m_end - m_next)) {
+        m_out.write(text.data(), static_cast<std::streamsize>(text.size())); // Too big to be worth copying
+        return;
+    }
+    std::memcpy(m_next, text.data(), text.size());
+    m_next += text.size();
+}
+
+void OutputBuffer::appendField(std::string_view field, OutputFormat format) {
+    switch (format) {
+        case OutputFormat::Plain:
+            append(field);
+            break;
+        case OutputFormat::Tsv: {
+            // Copy the runs between special bytes in one go, most fields have none
+            std::size_t start = 0;
+            for (std::size_t i = findSpecial(field, 0, 1); i < field.size(); i = findSpecial(field, i + 1, 1)) {
+                append(field.substr(start, i - start));
+                append('\\');
+                append(field[i] == '\t' ? 't' : field[i] == '\n' ? 'n' : field[i] == '\r' ? 'r' : '\\');
+                start = i + 1;
+            }
+            append(field.substr(start));
+            break;
+        }
+        case OutputFormat::Csv:
+            if (findSpecial(field, 0, 2) == field.size()) {
+                append(field);
+                break;
+            }
+            append('"');
+            for (std::size_t start = 0;;) {
+                std::size_t quote = field.find('"', start);
+                if (quote == std::string_view::npos) {
+                    append(field.substr(start));
+                    break;
+                }
+                append(field.substr(start, quote + 1 - start));
+                append('"'); // Doubled
+                start = quote + 1;
+            }
+            append('"');
+            break;
+    }
+}
+
+} // namespace contact_management
@@ -0,0 +1,63 @@
+// OutputBuffer.hpp
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include <ostream>
+#include <string_view>
+#include <memory>
+#include <cstddef>
+#include <cstring>
+
+namespace contact_management { // Everything in a self-made namespace
+
+// How contact listings are printed: the "Name: ..." blocks, or one row per contact for piping
+enum class OutputFormat {
+    Plain,
+    Tsv, // Tabs, newlines and backslashes in fields are written as \t, \n, \r and \\ (linear TSV)
+    Csv  // RFC 4180: fields with commas, quotes or line breaks are quoted, quotes doubled
+};
+
+// Formats into a fixed buffer and hands it to the stream in large writes, so a listing costs
+// one write per capacity bytes instead of a flush per line. Flushes on destruction.
+class OutputBuffer {
+public:
+    explicit OutputBuffer(std::ostream& out, std::size_t capacity = 64 * 1024);
+    ~OutputBuffer();
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    void append(std::string_view text) {
+        if (text.size() > static_cast<std::size_t>(m_end - m_next)) {
+            appendSlow(text);
+            return;
+        }
+        std::memcpy(m_next, text.data(), text.size());
+        m_next += text.size();
+    }
+    void append(char c) {
+        if (m_next == m_end) {
+            write();
+        }
+        *m_next++ = c;
+    }
+
+    // One field of a TSV / CSV row, escaped as the format needs (Plain appends it unchanged)
+    void appendField(std::string_view field, OutputFormat format);
+
+    // Write out what's buffered and flush the stream
+    void flush();
+
+private:
+    void appendSlow(std::string_view text);
+    void write();
+
+    std::ostream& m_out;
+    std::unique_ptr<char[]> m_buffer;
+    char* m_next;
+    char* m_end;
+};
+
+} // namespace contact_management
+
+#endif // OUTPUT_BUFFER_H
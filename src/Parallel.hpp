@@ -0,0 +1,54 @@
+// Parallel.hpp
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <thread>
+#include <vector>
+#include <exception>
+#include <cstddef>
+
+namespace contact_management { // Everything in a self-made namespace
+
+// Number of worker threads to use when the caller passes 0
+inline unsigned defaultThreadCount() {
+    unsigned count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : count;
+}
+
+// Run task(i) for every i in [0, taskCount), one thread per task (the calling thread runs task 0).
+// Waits for all tasks and rethrows the first exception any of them threw.
+template<typename Task>
+void runParallel(std::size_t taskCount, const Task& task) {
+    if (taskCount == 0) {
+        return;
+    }
+    std::vector<std::exception_ptr> errors(taskCount);
+    std::vector<std::thread> workers;
+    workers.reserve(taskCount - 1);
+    for (std::size_t i = 1; i < taskCount; ++i) {
+        workers.emplace_back([&task, &errors, i]() {
+            try {
+                task(i);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    try {
+        task(0);
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+} // namespace contact_management
+
+#endif // PARALLEL_H
@@ -0,0 +1,66 @@
+// SlotMap.cpp
+#include "SlotMap.hpp"
+#include <stdexcept>
+
+namespace contact_management { // Everything in a self-made namespace
+
+void SlotMap::reserve(std::size_t count) {
+    m_slots.reserve(count);
+    m_ids.reserve(count);
+}
+
+SlotId SlotMap::add() {
+    std::uint32_t slotIndex;
+    if (m_freeHead != noSlot) {
+        slotIndex = m_freeHead;
+        m_freeHead = m_slots[slotIndex].position;
+    } else {
+        if (m_slots.size() >= noSlot) {
+            throw std::runtime_error("Too many contacts");
+        }
+        slotIndex = static_cast<std::uint32_t>(m_slots.size());
+        m_slots.push_back(Slot{0, 0});
+    }
+    Slot& slot = m_slots[slotIndex];
+    ++slot.generation; // Even -> odd: in use (wraps after 2^31 reuses of the same slot)
+    slot.position = static_cast<std::uint32_t>(m_ids.size());
+    SlotId id = (static_cast<SlotId>(slot.generation) << 32) | slotIndex;
+    m_ids.push_back(id);
+    return id;
+}
+
+std::size_t SlotMap::find(SlotId id) const {
+    std::uint32_t slotIndex = static_cast<std::uint32_t>(id);
+    std::uint32_t generation = static_cast<std::uint32_t>(id >> 32);
+    if (slotIndex >= m_slots.size() || m_slots[slotIndex].generation != generation || generation % 2 == 0) {
+        return npos;
+    }
+    return m_slots[slotIndex].position;
+}
+
+void SlotMap::removeAt(std::size_t position) {
+    std::uint32_t slotIndex = static_cast<std::uint32_t>(m_ids[position]);
+    Slot& slot = m_slots[slotIndex];
+    ++slot.generation; // Odd -> even: free, every id handed out for it is now stale
+    slot.position = m_freeHead;
+    m_freeHead = slotIndex;
+
+    SlotId last = m_ids.back();
+    m_ids.pop_back();
+    if (position < m_ids.size()) {
+        m_ids[position] = last;
+        m_slots[static_cast<std::uint32_t>(last)].position = static_cast<std::uint32_t>(position);
+    }
+}
+
+void SlotMap::assign(std::size_t count) {
+    while (!m_ids.empty()) {
+        removeAt(m_ids.size() - 1);
+    }
+    reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        add();
+    }
+}
+
+} // namespace contact_management
@@ -0,0 +1,55 @@
+// SlotMap.hpp
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace contact_management { // Everything in a self-made namespace
+
+// 64-bit handle: low 32 bits are the slot, high 32 bits its generation. 0 is never a valid id.
+using SlotId = std::uint64_t;
+
+// Stable ids for the elements of a dense array kept by the caller. Removal swaps the last element
+// into the freed position, so ids stay valid while positions change; lookups and removals are O(1).
+// A removed id's slot is reused with a new generation, so stale ids are detected instead of aliasing.
+class SlotMap {
+public:
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    std::size_t size() const { return m_ids.size(); }
+    void reserve(std::size_t count);
+
+    // Id for a new element appended at position size()
+    SlotId add();
+
+    // Position of the element, or npos if the id was removed or never issued
+    std::size_t find(SlotId id) const;
+
+    // Id of the element at position (position < size())
+    SlotId idAt(std::size_t position) const { return m_ids[position]; }
+    const std::vector<SlotId>& ids() const { return m_ids; }
+
+    // Forget the element at position; the last element moves there, the caller mirrors that move
+    void removeAt(std::size_t position);
+
+    // Fresh ids for count elements at positions 0..count-1, all earlier ids become invalid
+    void assign(std::size_t count);
+
+private:
+    struct Slot {
+        std::uint32_t generation; // Odd while in use, so a fresh slot (generation 0) never matches
+        std::uint32_t position;   // Position of the element, or next free slot when unused
+    };
+
+    static const std::uint32_t noSlot = UINT32_MAX;
+
+    std::vector<Slot> m_slots;
+    std::vector<SlotId> m_ids; // Parallel to the caller's dense array
+    std::uint32_t m_freeHead = noSlot;
+};
+
+} // namespace contact_management
+
+#endif // SLOT_MAP_H
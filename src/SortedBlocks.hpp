@@ -0,0 +1,189 @@
+// SortedBlocks.hpp
+#ifndef SORTED_BLOCKS_H
+#define SORTED_BLOCKS_H
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <cstddef>
+
+namespace contact_management { // Everything in a self-made namespace
+
+// Sorted sequence (by T's operator<, which must order every pair of distinct elements) stored as a list
+// of sorted blocks of at most maxBlock elements. Finding a position is a binary search over the blocks
+// and then within one, so insert / erase cost O(log n + maxBlock) instead of moving every element after
+// the position as a flat sorted vector does. A block that overflows is split, which moves the n / maxBlock
+// block headers after it, once per maxBlock / 2 inserts into it. Reaching the element at a rank adds
+// up block sizes, O(n / maxBlock).
+template<typename T>
+class SortedBlocks {
+public:
+    static const std::size_t maxBlock = 1024;
+    using Block = std::vector<T>;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() : m_blocks(nullptr), m_block(0), m_offset(0) {}
+        const_iterator(const std::vector<Block>* blocks, std::size_t block, std::size_t offset)
+            : m_blocks(blocks), m_block(block), m_offset(offset) {}
+
+        reference operator*() const { return (*m_blocks)[m_block][m_offset]; }
+        pointer operator->() const { return &**this; }
+
+        const_iterator& operator++() {
+            if (++m_offset == (*m_blocks)[m_block].size()) {
+                ++m_block;
+                m_offset = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const { return m_block == other.m_block && m_offset == other.m_offset; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+        // Elements from first up to last, adding up the sizes of the blocks in between
+        friend std::size_t elementsBetween(const const_iterator& first, const const_iterator& last) {
+            std::size_t count = 0;
+            for (std::size_t block = first.m_block; block < last.m_block; ++block) {
+                count += (*first.m_blocks)[block].size();
+            }
+            return count + last.m_offset - first.m_offset;
+        }
+
+    private:
+        const std::vector<Block>* m_blocks;
+        std::size_t m_block;  // Blocks are never empty, so (block count, 0) is end()
+        std::size_t m_offset;
+    };
+
+    SortedBlocks() : m_size(0) {}
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const_iterator begin() const { return const_iterator(&m_blocks, 0, 0); }
+    const_iterator end() const { return const_iterator(&m_blocks, m_blocks.size(), 0); }
+
+    void clear() {
+        m_blocks.clear();
+        m_size = 0;
+    }
+
+    // Replace the contents by sorted, O(n). Blocks start half full, so inserts don't split them right away.
+    void assign(std::vector<T> sorted) {
+        clear();
+        for (std::size_t first = 0; first < sorted.size(); first += maxBlock / 2) {
+            std::size_t last = std::min(first + maxBlock / 2, sorted.size());
+            m_blocks.emplace_back(std::make_move_iterator(sorted.begin() + first), std::make_move_iterator(sorted.begin() + last));
+        }
+        m_size = sorted.size();
+    }
+
+    // All elements in order, for rebuilding through a merge
+    std::vector<T> toVector() const {
+        std::vector<T> values;
+        values.reserve(m_size);
+        for (const Block& block : m_blocks) {
+            values.insert(values.end(), block.begin(), block.end());
+        }
+        return values;
+    }
+
+    void insert(const T& value) {
+        if (m_blocks.empty()) {
+            m_blocks.emplace_back(1, value);
+            m_size = 1;
+            return;
+        }
+        std::size_t block = std::min(blockFor(value), m_blocks.size() - 1); // Past every block's last: the last one
+        Block& target = m_blocks[block];
+        target.insert(std::upper_bound(target.begin(), target.end(), value), value);
+        ++m_size;
+        if (target.size() > maxBlock) { // Split in halves
+            Block upper(std::make_move_iterator(target.begin() + maxBlock / 2), std::make_move_iterator(target.end()));
+            target.erase(target.begin() + maxBlock / 2, target.end());
+            m_blocks.insert(m_blocks.begin() + block + 1, std::move(upper));
+        }
+    }
+
+    // Returns whether value was there
+    bool erase(const T& value) {
+        std::size_t block = blockFor(value);
+        if (block == m_blocks.size()) {
+            return false;
+        }
+        Block& target = m_blocks[block];
+        auto it = std::lower_bound(target.begin(), target.end(), value);
+        if (it == target.end() || value < *it) {
+            return false;
+        }
+        target.erase(it);
+        --m_size;
+        if (target.empty()) {
+            m_blocks.erase(m_blocks.begin() + block);
+        } else if (target.size() < maxBlock / 4) { // Merged into a neighbour, so removals can't leave many tiny blocks
+            std::size_t first = block + 1 < m_blocks.size() ? block : block - (block > 0 ? 1 : 0);
+            if (first + 1 < m_blocks.size() && m_blocks[first].size() + m_blocks[first + 1].size() <= maxBlock) {
+                Block& into = m_blocks[first];
+                into.insert(into.end(), std::make_move_iterator(m_blocks[first + 1].begin()),
+                            std::make_move_iterator(m_blocks[first + 1].end()));
+                m_blocks.erase(m_blocks.begin() + first + 1);
+            }
+        }
+        return true;
+    }
+
+    // First element for which isBefore is false; isBefore must be true for a leading run and false after it.
+    // O(log n), like std::partition_point over the whole sequence.
+    template<typename Predicate>
+    const_iterator partitionPoint(Predicate isBefore) const {
+        auto block = std::partition_point(m_blocks.begin(), m_blocks.end(), [&isBefore](const Block& candidate) {
+            return isBefore(candidate.back());
+        });
+        if (block == m_blocks.end()) {
+            return end();
+        }
+        auto offset = std::partition_point(block->begin(), block->end(), isBefore); // Stops before back()
+        return const_iterator(&m_blocks, static_cast<std::size_t>(block - m_blocks.begin()),
+                              static_cast<std::size_t>(offset - block->begin()));
+    }
+
+    // The element at rank (end() past the last one)
+    const_iterator at(std::size_t rank) const {
+        for (std::size_t block = 0; block < m_blocks.size(); ++block) {
+            if (rank < m_blocks[block].size()) {
+                return const_iterator(&m_blocks, block, rank);
+            }
+            rank -= m_blocks[block].size();
+        }
+        return end();
+    }
+
+private:
+    // First block whose last element isn't before value (the block value belongs in), or the block count
+    std::size_t blockFor(const T& value) const {
+        auto block = std::partition_point(m_blocks.begin(), m_blocks.end(), [&value](const Block& candidate) {
+            return candidate.back() < value;
+        });
+        return static_cast<std::size_t>(block - m_blocks.begin());
+    }
+
+    std::vector<Block> m_blocks; // None of them empty; their concatenation is sorted
+    std::size_t m_size;
+};
+
+} // namespace contact_management
+
+#endif // SORTED_BLOCKS_H
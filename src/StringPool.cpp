@@ -0,0 +1,53 @@
+// StringPool.cpp
+#include "StringPool.hpp"
+#include <cstring>
+
+namespace contact_management { // Everything in a self-made namespace
+
+StringPool::StringPool(std::size_t chunkSize)
+    : m_chunkSize(chunkSize), m_chunkUsed(chunkSize), m_bytesUsed(0) {} // Start "full" so the first store allocates
+
+char* StringPool::allocate(std::size_t size) {
+    if (size > m_chunkSize / 4) {
+        // Large values get their own block so they don't waste the tail of the current chunk
+        m_largeBlocks.emplace_back(new char[size]); // Not make_unique: no need to zero the bytes
+        return m_largeBlocks.back().get();
+    }
+    if (m_chunkUsed + size > m_chunkSize) {
+        m_chunks.emplace_back(new char[m_chunkSize]);
+        m_chunkUsed = 0;
+    }
+    char* result = m_chunks.back().get() + m_chunkUsed;
+    m_chunkUsed += size;
+    return result;
+}
+
+std::string_view StringPool::store(std::string_view value) {
+    if (value.empty()) {
+        return std::string_view();
+    }
+    char* data = allocate(value.size());
+    std::memcpy(data, value.data(), value.size());
+    m_bytesUsed += value.size();
+    return std::string_view(data, value.size());
+}
+
+std::string_view StringPool::intern(std::string_view value) {
+    auto it = m_interned.find(value);
+    if (it != m_interned.end()) {
+        return *it;
+    }
+    std::string_view stored = store(value);
+    m_interned.insert(stored);
+    return stored;
+}
+
+void StringPool::clear() {
+    m_interned.clear();
+    m_chunks.clear();
+    m_largeBlocks.clear();
+    m_chunkUsed = m_chunkSize;
+    m_bytesUsed = 0;
+}
+
+} // namespace contact_management
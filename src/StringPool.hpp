@@ -0,0 +1,50 @@
+// StringPool.hpp
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <unordered_set>
+#include <cstddef>
+
+namespace contact_management { // Everything in a self-made namespace
+
+// Arena for string bytes: values are copied into large chunks and handed out as string_views.
+// Views stay valid until clear() or destruction, memory is released in bulk. ContactColumns interns its
+// company column here; the contacts themselves keep their own strings (see Contact.hpp).
+class StringPool {
+public:
+    explicit StringPool(std::size_t chunkSize = 64 * 1024);
+
+    StringPool(const StringPool&) = delete;            // Views point into our chunks
+    StringPool& operator=(const StringPool&) = delete;
+    StringPool(StringPool&&) = default;                 // Chunks don't move, so views survive a move
+    StringPool& operator=(StringPool&&) = default;
+
+    // Copy a value into the arena
+    std::string_view store(std::string_view value);
+
+    // Copy a value once, equal values return the same view (for repeated fields like company names)
+    std::string_view intern(std::string_view value);
+
+    // Drop all chunks at once
+    void clear();
+
+    std::size_t bytesUsed() const { return m_bytesUsed; }
+    std::size_t internedCount() const { return m_interned.size(); }
+
+private:
+    char* allocate(std::size_t size);
+
+    std::vector<std::unique_ptr<char[]>> m_chunks;
+    std::vector<std::unique_ptr<char[]>> m_largeBlocks;
+    std::size_t m_chunkSize;
+    std::size_t m_chunkUsed;  // Bytes used in the current (last) chunk
+    std::size_t m_bytesUsed;  // Bytes handed out over all chunks
+    std::unordered_set<std::string_view> m_interned;
+};
+
+} // namespace contact_management
+
+#endif // STRING_POOL_H
@@ -0,0 +1,204 @@
+// SubstringSearch.cpp
+#include "SubstringSearch.hpp"
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CONTACT_MANAGEMENT_HAS_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define CONTACT_MANAGEMENT_HAS_X86_SIMD 0
+#endif
+
+namespace contact_management { // Everything in a self-made namespace
+
+namespace {
+
+unsigned char foldAscii(unsigned char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c | 0x20) : c;
+}
+
+bool isAsciiLetter(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+// What the kernels need to know about the needle (never empty here)
+struct Pattern {
+    const char* data;
+    std::size_t size;
+    bool caseInsensitive;
+    unsigned char firstFold; // 0x20 when the first byte is a letter to fold, else 0
+    unsigned char lastFold;
+
+    // Full comparison at a candidate whose first and last bytes already matched
+    bool matchesAt(const char* candidate) const {
+        if (!caseInsensitive) {
+            return std::memcmp(candidate, data, size) == 0;
+        }
+        for (std::size_t i = 0; i < size; ++i) {
+            if (foldAscii(static_cast<unsigned char>(candidate[i])) != static_cast<unsigned char>(data[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+const char* findScalar(const char* begin, const char* end, const Pattern& pattern) {
+    if (static_cast<std::size_t>(end - begin) < pattern.size) {
+        return end;
+    }
+    if (!pattern.caseInsensitive) {
+        std::size_t pos = std::string_view(begin, static_cast<std::size_t>(end - begin))
+                              .find(std::string_view(pattern.data, pattern.size)); // memchr based in common libraries
+        return pos == std::string_view::npos ? end : begin + pos;
+    }
+    const char* last = end - pattern.size;
+    unsigned char first = static_cast<unsigned char>(pattern.data[0]);
+    for (const char* p = begin; p <= last; ++p) {
+        if ((static_cast<unsigned char>(*p) | pattern.firstFold) == first && pattern.matchesAt(p)) {
+            return p;
+        }
+    }
+    return end;
+}
+
+#if CONTACT_MANAGEMENT_HAS_X86_SIMD
+
+// Both kernels compare a block of candidate positions against the needle's first and last bytes at once
+// and only check the few positions where both agree. OR-ing 0x20 folds a letter to lower case, and only
+// letters fold onto letters, so it can't create false matches.
+
+__attribute__((target("sse2")))
+const char* findSse2(const char* begin, const char* end, const Pattern& pattern) {
+    const std::size_t span = 16 + pattern.size - 1; // Bytes read per block
+    const __m128i first = _mm_set1_epi8(pattern.data[0]);
+    const __m128i last = _mm_set1_epi8(pattern.data[pattern.size - 1]);
+    const __m128i firstFold = _mm_set1_epi8(static_cast<char>(pattern.firstFold));
+    const __m128i lastFold = _mm_set1_epi8(static_cast<char>(pattern.lastFold));
+    const char* p = begin;
+    for (; static_cast<std::size_t>(end - p) >= span; p += 16) {
+        __m128i a = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), firstFold);
+        __m128i b = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + pattern.size - 1)), lastFold);
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+        for (; mask != 0; mask &= mask - 1) {
+            const char* candidate = p + __builtin_ctz(mask);
+            if (pattern.matchesAt(candidate)) {
+                return candidate;
+            }
+        }
+    }
+    return findScalar(p, end, pattern);
+}
+
+__attribute__((target("avx2")))
+const char* findAvx2(const char* begin, const char* end, const Pattern& pattern) {
+    const std::size_t span = 32 + pattern.size - 1;
+    const __m256i first = _mm256_set1_epi8(pattern.data[0]);
+    const __m256i last = _mm256_set1_epi8(pattern.data[pattern.size - 1]);
+    const __m256i firstFold = _mm256_set1_epi8(static_cast<char>(pattern.firstFold));
+    const __m256i lastFold = _mm256_set1_epi8(static_cast<char>(pattern.lastFold));
+    const char* p = begin;
+    for (; static_cast<std::size_t>(end - p) >= span; p += 32) {
+        __m256i a = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), firstFold);
+        __m256i b = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + pattern.size - 1)), lastFold);
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+        for (; mask != 0; mask &= mask - 1) {
+            const char* candidate = p + __builtin_ctz(mask);
+            if (pattern.matchesAt(candidate)) {
+                return candidate;
+            }
+        }
+    }
+    return findScalar(p, end, pattern);
+}
+
+#endif
+
+using FindFunction = const char* (*)(const char*, const char*, const Pattern&);
+
+struct Kernel {
+    FindFunction find;
+    const char* name;
+};
+
+Kernel selectKernel() {
+#if CONTACT_MANAGEMENT_HAS_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Kernel{findAvx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return Kernel{findSse2, "sse2"};
+    }
+#endif
+    return Kernel{findScalar, "scalar"};
+}
+
+const Kernel& kernel() {
+    static const Kernel selected = selectKernel(); // Checked once, thread-safe since C++11
+    return selected;
+}
+
+} // namespace
+
+SubstringSearcher::SubstringSearcher(std::string_view needle, bool caseInsensitive)
+    : m_needle(needle), m_caseInsensitive(caseInsensitive) {
+    if (caseInsensitive) {
+        for (char& c : m_needle) {
+            c = static_cast<char>(foldAscii(static_cast<unsigned char>(c)));
+        }
+    }
+}
+
+const char* SubstringSearcher::find(const char* begin, const char* end) const {
+    Pattern pattern{m_needle.data(), m_needle.size(), m_caseInsensitive, 0, 0};
+    if (m_caseInsensitive) {
+        pattern.firstFold = isAsciiLetter(static_cast<unsigned char>(m_needle.front())) ? 0x20 : 0;
+        pattern.lastFold = isAsciiLetter(static_cast<unsigned char>(m_needle.back())) ? 0x20 : 0;
+    }
+    return kernel().find(begin, end, pattern);
+}
+
+bool SubstringSearcher::contains(std::string_view value) const {
+    if (m_needle.empty()) {
+        return true;
+    }
+    const char* end = value.data() + value.size();
+    return find(value.data(), end) != end;
+}
+
+void SubstringSearcher::scanColumn(const StringColumn& column, std::size_t firstRow, std::size_t lastRow,
+                                   std::uint64_t* bits) const {
+    if (m_needle.empty()) {
+        for (std::size_t row = firstRow; row < lastRow; ++row) {
+            bits[(row - firstRow) / 64] |= std::uint64_t(1) << ((row - firstRow) % 64);
+        }
+        return;
+    }
+    const char* data = column.bytes().data();
+    const std::size_t* offsets = column.offsets().data();
+    const char* end = data + offsets[lastRow];
+    const char* p = data + offsets[firstRow];
+    std::size_t row = firstRow;
+    while (p < end) {
+        const char* hit = find(p, end);
+        if (hit == end) {
+            break;
+        }
+        std::size_t pos = static_cast<std::size_t>(hit - data);
+        while (offsets[row + 1] <= pos) {
+            ++row;
+        }
+        // A hit running past its row's end straddles two values, and so would every later hit in that row
+        if (pos + m_needle.size() <= offsets[row + 1]) {
+            bits[(row - firstRow) / 64] |= std::uint64_t(1) << ((row - firstRow) % 64);
+        }
+        p = data + offsets[row + 1]; // One hit per row is enough
+    }
+}
+
+const char* SubstringSearcher::implementation() {
+    return kernel().name;
+}
+
+} // namespace contact_management
@@ -0,0 +1,38 @@
+// SubstringSearch.hpp
+#ifndef SUBSTRING_SEARCH_H
+#define SUBSTRING_SEARCH_H
+
+#include "ContactColumns.hpp"
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+namespace contact_management { // Everything in a self-made namespace
+
+// Finds a needle in field values. On x86 the search uses AVX2 or SSE2, whichever the CPU running
+// the program supports (checked once at run time), otherwise a portable scalar loop.
+// Case-insensitive mode folds ASCII letters only.
+class SubstringSearcher {
+public:
+    SubstringSearcher(std::string_view needle, bool caseInsensitive);
+
+    bool contains(std::string_view value) const;
+
+    // Set bit (row - firstRow) of bits for every row in [firstRow, lastRow) whose value contains the
+    // needle. Searches the column's contiguous bytes in one pass instead of value by value.
+    void scanColumn(const StringColumn& column, std::size_t firstRow, std::size_t lastRow, std::uint64_t* bits) const;
+
+    // "avx2", "sse2" or "scalar"
+    static const char* implementation();
+
+private:
+    const char* find(const char* begin, const char* end) const; // First match in [begin, end), or end
+
+    std::string m_needle; // Lower-cased in case-insensitive mode
+    bool m_caseInsensitive;
+};
+
+} // namespace contact_management
+
+#endif // SUBSTRING_SEARCH_H
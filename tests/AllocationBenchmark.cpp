@@ -0,0 +1,122 @@
+// AllocationBenchmark.cpp
+// Counts heap allocations (through a replaced global operator new) and time per row for the scan paths:
+// filtering on every field, name lookups, visiting, saving and exporting. Once the contacts are loaded
+// these should not allocate per row, only a fixed amount per call (result vectors, file streams).
+// Fields are longer than the small string buffer, so any string copy shows up as an allocation.
+#include "../src/ContactManager.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+
+using namespace contact_management;
+
+namespace {
+
+// Only the benchmarking thread counts, the auto-save thread may allocate whenever it likes
+thread_local bool isCounting = false;
+std::atomic<std::size_t> allocationCount{0};
+
+void* allocate(std::size_t size) {
+    if (isCounting) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace {
+
+const std::size_t contactCount = 100000;
+const double maxAllocationsPerRow = 0.01; // A fixed number per call, not one per row
+
+int failures = 0;
+
+std::string longName(std::size_t i) { return "Contact name number " + std::to_string(i % 20000); }
+
+// Runs scan once with counting on, prints allocations and time per row, and checks the allocation budget
+void measure(const char* label, std::size_t rows, const std::function<void()>& scan, bool isChecked = true) {
+    allocationCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    isCounting = true;
+    scan();
+    isCounting = false;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double perRow = static_cast<double>(allocationCount.load()) / rows;
+    bool isOk = !isChecked || perRow <= maxAllocationsPerRow;
+    std::printf("%-32s %8.3f allocations/row %8.1f ns/row%s\n", label, perRow, seconds * 1e9 / rows, isOk ? "" : "  FAILED");
+    if (!isOk) {
+        ++failures;
+    }
+}
+
+} // namespace
+
+int main() {
+    std::remove("auto_save.txt"); // Old auto-save files would only be noise here
+    std::remove("auto_save.journal");
+
+    ContactManager manager;
+    {
+        ContactManager::Batch batch = manager.beginBatch();
+        for (std::size_t i = 0; i < contactCount; ++i) {
+            std::string phone = "+1 555 0100 " + std::to_string(i) + " extension";
+            std::string email = "someone.with.a.long.address" + std::to_string(i) + "@example.com";
+            if (i % 4 == 0) {
+                batch.add(std::make_shared<BusinessContact>(longName(i), std::move(phone), std::move(email),
+                                                            "Company with a long name " + std::to_string(i % 100)));
+            } else {
+                batch.add(std::make_shared<Contact>(longName(i), std::move(phone), std::move(email)));
+            }
+        }
+        batch.commit();
+    }
+    manager.saveToFile("benchmark_warmup.txt"); // First calls build lazy caches, those aren't per-scan costs
+    manager.findContactsByName(longName(0));
+
+    measure("filterContacts (every getter)", contactCount, [&manager] {
+        std::size_t length = 0;
+        manager.filterContacts([&length](const Contact& contact) {
+            length += contact.getName().size() + contact.getPhone().size() + contact.getEmail().size();
+            if (contact.isBusiness()) {
+                length += static_cast<const BusinessContact&>(contact).getCompany().size();
+            }
+            return false;
+        });
+    });
+    measure("visitContacts", contactCount, [&manager] {
+        std::size_t length = 0;
+        manager.visitContacts([&length](const Contact& contact) { length += contact.getNameView().size(); },
+                              [&length](const BusinessContact& contact) { length += contact.getCompanyView().size(); });
+    });
+    const std::size_t lookups = 20000;
+    std::string name = longName(0);
+    measure("findContactsByName (per call)", lookups, [&manager, &name, lookups] {
+        for (std::size_t i = 0; i < lookups; ++i) {
+            name.replace(name.rfind(' ') + 1, std::string::npos, std::to_string(i)); // Stays in its buffer
+            manager.findContactsByName(name);
+        }
+    }, false); // Not per row: each call grows a new result vector for its matches (5 here, so 4 allocations)
+    measure("saveToFile", contactCount, [&manager] { manager.saveToFile("benchmark_contacts.txt"); });
+    measure("exportToJson", contactCount, [&manager] { manager.exportToJson("benchmark_contacts.json"); });
+    measure("loadFromFile (not checked)", contactCount, [] {
+        ContactManager loaded;
+        loaded.loadFromFile("benchmark_contacts.txt"); // Contacts, their strings and index nodes are expected
+    }, false);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,246 @@
+// IndexScalingTest.cpp
+// Index upkeep must not grow with the number of contacts sharing a key. Each case runs at two sizes,
+// checks the results and fails if the time grows much faster than it should (a removal that walks every
+// contact of the company made removing all of them quadratic: 4x the contacts took 16x the time).
+#include "../src/ContactManager.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace contact_management;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                                   \
+        }                                                                                 \
+    } while (false)
+
+const std::size_t smallSize = 20000;
+
+std::vector<std::shared_ptr<const Contact>> sameCompany(std::size_t count, std::size_t first = 0) {
+    std::vector<std::shared_ptr<const Contact>> contacts;
+    contacts.reserve(count);
+    for (std::size_t i = first; i < first + count; ++i) {
+        contacts.push_back(std::make_shared<BusinessContact>("Name " + std::to_string(i % 100), "+1555" + std::to_string(i),
+                                                             "user" + std::to_string(i) + "@example.com", "Acme"));
+    }
+    return contacts;
+}
+
+double secondsOf(const std::function<void()>& work) {
+    auto start = std::chrono::steady_clock::now();
+    work();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Runs the case at smallSize and largeSize and checks the growth; run(size) returns the seconds its timed part took
+void checkScaling(const char* label, std::size_t largeSize, double maxGrowth, const std::function<double(std::size_t)>& run) {
+    double small = run(smallSize);
+    double large = run(largeSize);
+    double growth = large / std::max(small, 1e-6);
+    bool isOk = growth <= maxGrowth;
+    std::printf("%-40s %8.4fs at %zu, %8.4fs at %zu (%.1fx)%s\n", label, small, smallSize, large, largeSize, growth,
+                isOk ? "" : "  FAILED");
+    if (!isOk) {
+        ++failures;
+    }
+}
+
+// Every contact shares the company and one of 100 names, removed in one batch. Hash indexes email and phone too.
+double bulkRemoveSameCompany(std::size_t size) {
+    ContactManager manager;
+    std::vector<ContactId> ids = manager.addContacts(sameCompany(size));
+    manager.findByEmail("user0@example.com"); // Builds the email and phone indexes, so they are kept up to date too
+    manager.findByPhone("+15550");
+    std::vector<ContactId> removed(ids.begin(), ids.begin() + size / 2);
+    double seconds = secondsOf([&manager, &removed] { manager.removeContactsById(removed); });
+
+    CHECK(manager.getContactCount() == size - size / 2);
+    CHECK(manager.findByCompany("Acme").size() == size - size / 2);
+    CHECK(manager.findContactsByName("Name 1").size() == (size - size / 2) / 100);
+    CHECK(manager.findByEmail("user0@example.com").empty());
+    CHECK(manager.findByEmail("user" + std::to_string(size - 1) + "@example.com").size() == 1);
+    return seconds;
+}
+
+// A fixed number of single removals by id, so the time per removal must not depend on the size
+double removeByIdSameCompany(std::size_t size) {
+    const std::size_t removals = 5000;
+    ContactManager manager;
+    std::vector<ContactId> ids = manager.addContacts(sameCompany(size));
+    double seconds = secondsOf([&manager, &ids, removals] {
+        for (std::size_t i = 0; i < removals; ++i) {
+            manager.removeContactById(ids[i * 2]); // Spread over the company's entries, not just its oldest
+        }
+    });
+
+    CHECK(manager.getContactCount() == size - removals);
+    CHECK(manager.findByCompany("Acme").size() == size - removals);
+    CHECK(manager.findContactById(ids[0]) == nullptr);
+    CHECK(manager.findContactById(ids[1]) != nullptr);
+    return seconds;
+}
+
+// A bulk sync: one batch removes half of a company by id and adds as many new contacts to it, with the
+// hash indexes and the name sorted index built, so every index takes part
+double batchSyncSameCompany(std::size_t size) {
+    ContactManager manager;
+    std::vector<ContactId> ids = manager.addContacts(sameCompany(size));
+    manager.findByEmail("user0@example.com");
+    manager.page(0, 10);
+    double seconds = secondsOf([&manager, &ids, size] {
+        ContactManager::Batch batch = manager.beginBatch();
+        for (std::size_t i = 0; i < size / 2; ++i) {
+            batch.removeById(ids[i]);
+        }
+        for (auto& contact : sameCompany(size / 2, size)) {
+            batch.add(std::move(contact));
+        }
+        batch.commit();
+    });
+
+    CHECK(manager.getContactCount() == size);
+    CHECK(manager.findByCompany("Acme").size() == size);
+    CHECK(manager.findByEmail("user0@example.com").empty());
+    CHECK(manager.findByEmail("user" + std::to_string(size) + "@example.com").size() == 1);
+    std::vector<std::shared_ptr<const Contact>> page = manager.page(0, size + 1);
+    CHECK(page.size() == size);
+    for (std::size_t i = 1; i < page.size(); ++i) {
+        CHECK(page[i - 1]->getName() <= page[i]->getName());
+    }
+    return seconds;
+}
+
+// A fixed number of single adds and removes with all four sorted indexes built, so again the time per
+// change must not depend on the size (a flat sorted array moves every entry after the position)
+double singleChangesSorted(std::size_t size) {
+    const std::size_t changes = 2000;
+    ContactManager manager;
+    manager.addContacts(sameCompany(size));
+    for (ContactField field : {ContactField::Name, ContactField::Phone, ContactField::Email, ContactField::Company}) {
+        manager.page(0, 1, field);
+    }
+    std::vector<std::shared_ptr<const Contact>> added = sameCompany(changes, size);
+    std::vector<ContactId> ids;
+    double seconds = secondsOf([&manager, &added, &ids] {
+        for (auto& contact : added) {
+            ids.push_back(manager.addContact(std::move(contact)));
+        }
+        for (std::size_t i = 0; i < ids.size(); i += 2) {
+            manager.removeContactById(ids[i]);
+        }
+    });
+
+    CHECK(manager.getContactCount() == size + changes / 2);
+    auto keyOf = [](const Contact& contact, ContactField field) {
+        return field == ContactField::Name ? contact.getNameView() : field == ContactField::Phone ? contact.getPhoneView() : contact.getEmailView();
+    };
+    for (ContactField field : {ContactField::Name, ContactField::Phone, ContactField::Email}) {
+        std::vector<std::shared_ptr<const Contact>> page = manager.page(size / 2, 1000, field);
+        CHECK(page.size() == 1000);
+        for (std::size_t i = 1; i < page.size(); ++i) {
+            CHECK(keyOf(*page[i - 1], field) <= keyOf(*page[i], field));
+        }
+    }
+    CHECK(manager.findByPhonePrefix("+1555" + std::to_string(size)).empty()); // The first one added was removed again
+    CHECK(manager.findByPhonePrefix("+1555" + std::to_string(size + 1)).size() == 1);
+    return seconds;
+}
+
+// Appending a JSON Lines file with the hash and all four sorted indexes built, under Merge: a tenth of the
+// lines are new contacts, a tenth rename current ones (same phone, no email). Both grow with the size, so linear
+// is about 4x again.
+double appendJsonLinesSorted(std::size_t size) {
+    ContactManager manager;
+    manager.addContacts(sameCompany(size));
+    manager.findByEmail("user0@example.com");
+    for (ContactField field : {ContactField::Name, ContactField::Phone, ContactField::Email, ContactField::Company}) {
+        manager.page(0, 1, field);
+    }
+    const std::string filename = "append_test.jsonl";
+    {
+        ContactManager source;
+        std::vector<std::shared_ptr<const Contact>> lines = sameCompany(size / 10, size);
+        for (std::size_t i = 0; i < size / 10; ++i) {
+            lines.push_back(std::make_shared<Contact>("Renamed " + std::to_string(i), "+1555" + std::to_string(i), ""));
+        }
+        source.addContacts(std::move(lines));
+        source.exportToJsonLines(filename);
+    }
+    std::size_t offset = 0;
+    double seconds = secondsOf([&manager, &filename, &offset] {
+        offset = manager.appendFromJsonLines(filename, 0, 1, DuplicatePolicy::Merge);
+    });
+    std::remove(filename.c_str());
+
+    CHECK(offset > 0);
+    CHECK(manager.getContactCount() == size + size / 10);
+    CHECK(manager.findByCompany("Acme").size() == size + size / 10); // Merging kept the renamed ones' company
+    std::vector<std::shared_ptr<const Contact>> renamed = manager.findByPhone("+15550");
+    CHECK(renamed.size() == 1 && renamed[0]->getName() == "Renamed 0" && renamed[0]->getEmail() == "user0@example.com");
+    CHECK(manager.findContactsByName("Renamed " + std::to_string(size / 10 - 1)).size() == 1);
+    CHECK(manager.findByEmail("user" + std::to_string(size) + "@example.com").size() == 1);
+    for (ContactField field : {ContactField::Name, ContactField::Phone}) {
+        std::vector<std::shared_ptr<const Contact>> page = manager.page(0, size + size / 10 + 1, field);
+        CHECK(page.size() == size + size / 10);
+        for (std::size_t i = 1; i < page.size(); ++i) {
+            CHECK(field == ContactField::Name ? page[i - 1]->getName() <= page[i]->getName()
+                                              : page[i - 1]->getPhone() <= page[i]->getPhone());
+        }
+    }
+    CHECK(manager.findByPhonePrefix("+15550").front()->getName() == "Renamed 0"); // The merged contact replaced the old one
+    return seconds;
+}
+
+// Not timed: a batched Merge must match importing line by line, where each line merges into the oldest
+// contact left with its key. Current contacts come before appended ones, even when both share a key.
+void appendMergeOrder() {
+    ContactManager manager;
+    manager.addContacts({std::make_shared<Contact>("First", "+1001", "same@example.com"),
+                         std::make_shared<Contact>("Second", "+1002", "same@example.com")}); // Kept as loaded
+    const std::string filename = "append_order.jsonl";
+    {
+        ContactManager source;
+        source.addContacts({std::make_shared<Contact>("", "+1003", "same@example.com"),   // Into First
+                            std::make_shared<Contact>("", "+1004", "same@example.com"),   // Into Second, still current
+                            std::make_shared<Contact>("Last", "+1005", "same@example.com")}); // Into the first merged one
+        source.exportToJsonLines(filename);
+    }
+    manager.appendFromJsonLines(filename, 0, 1, DuplicatePolicy::Merge);
+    std::remove(filename.c_str());
+
+    CHECK(manager.getContactCount() == 2);
+    CHECK(manager.findByPhone("+1003").empty());
+    std::vector<std::shared_ptr<const Contact>> second = manager.findByPhone("+1004");
+    CHECK(second.size() == 1 && second[0]->getName() == "Second");
+    std::vector<std::shared_ptr<const Contact>> last = manager.findByPhone("+1005");
+    CHECK(last.size() == 1 && last[0]->getName() == "Last");
+}
+
+} // namespace
+
+int main() {
+    std::remove("auto_save.txt"); // The managers' auto-saves aren't used here
+    std::remove("auto_save.journal");
+
+    // Linear is about 4x, quadratic 16x; the slack absorbs cache effects and noise
+    checkScaling("removeContactsById, one company", 4 * smallSize, 10, bulkRemoveSameCompany);
+    checkScaling("Batch sync (remove + add), one company", 4 * smallSize, 10, batchSyncSameCompany);
+    // O(1) stays about 1x, a walk over the company's entries would be 16x
+    checkScaling("5000 x removeContactById, one company", 16 * smallSize, 4, removeByIdSameCompany);
+    checkScaling("2000 adds + 1000 removes, sorted indexes", 16 * smallSize, 4, singleChangesSorted);
+    checkScaling("appendFromJsonLines (Merge), sorted", 4 * smallSize, 10, appendJsonLinesSorted);
+    appendMergeOrder();
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
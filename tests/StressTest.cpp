@@ -0,0 +1,211 @@
+// StressTest.cpp
+// Hammers one ContactManager from several threads at once: writers add and remove (one by one and in
+// batches), readers run every kind of query, a saver writes text / JSON / snapshot files, and the
+// auto-save thread journals and compacts underneath. Afterwards the contacts must add up and both a
+// reload and an auto-save recovery must give them back. Run it under -fsanitize=thread to check for races.
+#include "../src/ContactManager.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace contact_management;
+
+namespace {
+
+std::atomic<int> failures{0};
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                                   \
+        }                                                                                 \
+    } while (false)
+
+const int writerCount = 2;
+const int readerCount = 3;
+const auto runTime = std::chrono::seconds(2);
+
+std::shared_ptr<const Contact> makeContact(int writer, int serial) {
+    std::string name = "Name" + std::to_string(serial % 500);
+    std::string phone = "+1555" + std::to_string(writer) + std::to_string(serial);
+    std::string email = "user" + std::to_string(writer) + "_" + std::to_string(serial) + "@example.com";
+    if (serial % 3 == 0) {
+        return std::make_shared<BusinessContact>(std::move(name), std::move(phone), std::move(email),
+                                                 "Company" + std::to_string(serial % 20));
+    }
+    return std::make_shared<Contact>(std::move(name), std::move(phone), std::move(email));
+}
+
+// Each writer only removes contacts it added itself, so its removals never hit an id another thread removed
+void writer(ContactManager& manager, int id, std::atomic<bool>& stop, std::atomic<long>& expectedCount) {
+    std::mt19937 random(id);
+    std::vector<ContactId> mine;
+    int serial = 0;
+    while (!stop) {
+        switch (random() % 8) {
+            case 0: { // A batch of adds and removes under one lock
+                ContactManager::Batch batch = manager.beginBatch();
+                int adds = 1 + static_cast<int>(random() % 40);
+                for (int i = 0; i < adds; ++i) {
+                    batch.add(makeContact(id, serial++));
+                }
+                int removes = mine.empty() ? 0 : static_cast<int>(random() % std::min<std::size_t>(mine.size(), 20));
+                for (int i = 0; i < removes; ++i) {
+                    batch.removeById(mine.back());
+                    mine.pop_back();
+                }
+                std::vector<ContactId> added = batch.commit();
+                CHECK(added.size() == static_cast<std::size_t>(adds));
+                mine.insert(mine.end(), added.begin(), added.end());
+                expectedCount += adds - removes;
+                break;
+            }
+            case 1:
+            case 2:
+                if (!mine.empty()) {
+                    std::size_t pick = random() % mine.size();
+                    manager.removeContactById(mine[pick]);
+                    mine[pick] = mine.back();
+                    mine.pop_back();
+                    --expectedCount;
+                    break;
+                }
+                // Nothing to remove yet, add instead
+                // fall through
+            default:
+                mine.push_back(manager.addContact(makeContact(id, serial++)));
+                ++expectedCount;
+                break;
+        }
+        if (!mine.empty() && random() % 50 == 0) {
+            manager.setFavoriteContactById(mine[random() % mine.size()]);
+        }
+    }
+}
+
+void reader(const ContactManager& manager, int id, std::atomic<bool>& stop) {
+    std::mt19937 random(100 + id);
+    while (!stop) {
+        std::string name = "Name" + std::to_string(random() % 500);
+        switch (random() % 9) {
+            case 0:
+                for (const auto& contact : manager.findContactsByName(name)) {
+                    CHECK(contact && contact->getName() == name);
+                }
+                break;
+            case 1: {
+                std::string email = "user0_" + std::to_string(random() % 2000) + "@example.com";
+                for (const auto& contact : manager.findByEmail(email)) {
+                    CHECK(contact && contact->getEmail() == email);
+                }
+                break;
+            }
+            case 2: {
+                std::vector<std::shared_ptr<const Contact>> page = manager.page(random() % 1000, 50);
+                for (std::size_t i = 1; i < page.size(); ++i) {
+                    CHECK(page[i - 1]->getName() <= page[i]->getName());
+                }
+                break;
+            }
+            case 3:
+                for (const auto& contact : manager.findByNamePrefix("Name1")) {
+                    CHECK(contact->getName().compare(0, 5, "Name1") == 0);
+                }
+                break;
+            case 4: {
+                ContactQuery query = ContactQuery::equals(ContactField::Company, "Company3") && ContactQuery::isBusiness();
+                for (const auto& contact : manager.findContacts(query)) {
+                    CHECK(contact->isBusiness() && contact->getCompanyView() == "Company3");
+                }
+                break;
+            }
+            case 5:
+                for (const auto& match : manager.findFuzzy(name, 1, 5)) {
+                    CHECK(match.contact && match.distance <= 1);
+                }
+                break;
+            case 6:
+                for (const auto& contact : manager.findContaining(ContactField::Email, "_1", false, 1)) {
+                    CHECK(contact->getEmail().find("_1") != std::string::npos);
+                }
+                break;
+            case 7: {
+                std::size_t business = 0;
+                manager.visitContacts([](const Contact&) {}, [&business](const BusinessContact&) { ++business; });
+                CHECK(business <= manager.getContactCount() + 10000); // Bounded; writers keep going meanwhile
+                break;
+            }
+            default:
+                for (const auto& contact : manager.getAllContacts()) {
+                    CHECK(contact != nullptr);
+                }
+                break;
+        }
+    }
+}
+
+void saver(const ContactManager& manager, std::atomic<bool>& stop) {
+    while (!stop) {
+        manager.saveToFile("stress_contacts.txt");
+        manager.exportToJson("stress_contacts.json", true);
+        manager.saveSnapshot("stress_contacts.bin");
+        manager.getFavoriteContact();
+    }
+}
+
+} // namespace
+
+int main() {
+    std::remove("auto_save.txt"); // Start from a clean auto-save, recovery is checked at the end
+    std::remove("auto_save.journal");
+    std::remove("auto_save.journal.tmp");
+
+    std::atomic<long> expectedCount{0};
+    std::size_t finalCount = 0;
+    {
+        ContactManager manager;
+        AutoSavePolicy policy;
+        policy.maxLatency = std::chrono::milliseconds(5);
+        policy.journalCompactionBytes = 64 * 1024; // Small, so compactions run during the test too
+        manager.setAutoSavePolicy(policy);
+
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> threads;
+        for (int i = 0; i < writerCount; ++i) {
+            threads.emplace_back(writer, std::ref(manager), i, std::ref(stop), std::ref(expectedCount));
+        }
+        for (int i = 0; i < readerCount; ++i) {
+            threads.emplace_back(reader, std::cref(manager), i, std::ref(stop));
+        }
+        threads.emplace_back(saver, std::cref(manager), std::ref(stop));
+        std::this_thread::sleep_for(runTime);
+        stop = true;
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        finalCount = manager.getContactCount();
+        CHECK(finalCount == static_cast<std::size_t>(expectedCount.load()));
+        CHECK(manager.getAllContacts().size() == finalCount);
+        CHECK(manager.getContactIds().size() == finalCount);
+        CHECK(manager.page(0, finalCount + 1).size() == finalCount);
+
+        manager.saveToFile("stress_contacts.txt");
+        ContactManager reloaded;
+        reloaded.loadFromFile("stress_contacts.txt");
+        CHECK(reloaded.getContactCount() == finalCount);
+    } // The destructor makes the last edits durable
+
+    ContactManager recovered;
+    CHECK(recovered.recoverFromAutoSave());
+    CHECK(recovered.getContactCount() == finalCount);
+
+    std::printf("%zu contacts, %d failed checks\n", finalCount, failures.load());
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}